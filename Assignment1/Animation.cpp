@@ -0,0 +1,15 @@
+#include "Animation.h"
+#include "RunnerWorld.h"
+#include <cmath>
+
+// 0.005 rad per millisecond of game time, 5 px either way
+static const double BOB_RADIANS_PER_TICK = 0.005 * 1000 / TICK_RATE;
+static const float BOB_AMPLITUDE = 5.0f;
+
+void AnimationClock::sample() const {
+    double angle = tick * BOB_RADIANS_PER_TICK;
+    for (int phase = 0; phase < BOB_PHASES; phase++) {
+        powerupBobs[phase] = float(cos(angle + phase * 2 * M_PI / BOB_PHASES)) * BOB_AMPLITUDE;
+    }
+    sampledTick = tick;
+}
@@ -0,0 +1,35 @@
+#ifndef ANIMATION_H
+#define ANIMATION_H
+
+#include <cstdint>
+
+// Bobbing objects are split into this many groups, evenly spread around the
+// cycle, so they do not all move in lockstep.
+const int BOB_PHASES = 8;
+
+// Animation time for one world, counted in simulation ticks rather than read
+// from the wall clock, so a replay animates exactly like the original run.
+// The clock itself is one counter bumped per tick; the bob offsets are only
+// worked out when something asks for them (i.e. when a frame is drawn), once
+// per tick for all objects.
+class AnimationClock {
+public:
+    void reset() { tick = 0; }
+    void advance() { tick++; }
+    long long ticks() const { return tick; }
+
+    // Vertical bob of a powerup in the given phase group
+    float powerupBob(uint8_t phase) const {
+        if (sampledTick != tick) sample();
+        return powerupBobs[phase % BOB_PHASES];
+    }
+
+private:
+    void sample() const;
+
+    long long tick = 0;
+    mutable long long sampledTick = -1;
+    mutable float powerupBobs[BOB_PHASES];
+};
+
+#endif
@@ -0,0 +1,329 @@
+#include "Audio.h"
+#include "ByteIO.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#ifdef RUNNER_OPENAL
+#if __has_include(<OpenAL/al.h>)
+#include <OpenAL/al.h>
+#include <OpenAL/alc.h>
+#elif __has_include(<AL/al.h>)
+#include <AL/al.h>
+#include <AL/alc.h>
+#else
+#include <al.h>
+#include <alc.h>
+#endif
+#endif
+
+static const char* SOUND_FILES[SOUND_COUNT] = {
+    "jump-sound.wav",
+    "collision-sound.wav",
+    "collect-sound.wav",
+    "lose-sound.wav",
+    "win-sound.wav",
+};
+
+bool decodeWav(const char* path, SoundBuffer& buffer) {
+    std::vector<uint8_t> data;
+    if (!readFile(path, data)) return false;
+    if (data.size() < 12 || memcmp(data.data(), "RIFF", 4) != 0 || memcmp(data.data() + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+
+    // Walk the chunks for "fmt " and "data", skipping anything else (bext,
+    // LIST, ...). Chunks are padded to an even size.
+    ByteReader reader{data};
+    reader.pos = 12;
+    uint64_t format = 0, channels = 0, rate = 0, bits = 0;
+    const uint8_t* pcm = nullptr;
+    size_t pcmBytes = 0;
+    while (reader.pos + 8 <= data.size()) {
+        const uint8_t* id = data.data() + reader.pos;
+        reader.pos += 4;
+        uint64_t size;
+        reader.getUnsigned(size, 4);
+        size_t start = reader.pos;
+        size = std::min<uint64_t>(size, data.size() - start);
+        if (memcmp(id, "fmt ", 4) == 0 && size >= 16) {
+            uint64_t skip;
+            reader.getUnsigned(format, 2);
+            reader.getUnsigned(channels, 2);
+            reader.getUnsigned(rate, 4);
+            reader.getUnsigned(skip, 4); // Byte rate
+            reader.getUnsigned(skip, 2); // Block align
+            reader.getUnsigned(bits, 2);
+        } else if (memcmp(id, "data", 4) == 0) {
+            pcm = data.data() + start;
+            pcmBytes = size_t(size);
+        }
+        reader.pos = start + size_t(size) + (size & 1);
+    }
+    if (!pcm || format != 1 || (channels != 1 && channels != 2) || (bits != 8 && bits != 16) || rate == 0) {
+        return false;
+    }
+
+    int bytesPerSample = int(bits / 8);
+    int sourceFrames = int(pcmBytes / (bytesPerSample * channels));
+    auto sample = [&](int frame, int channel) -> int {
+        const uint8_t* p = pcm + (size_t(frame) * channels + (channels == 2 ? channel : 0)) * bytesPerSample;
+        return bits == 8 ? (int(p[0]) - 128) << 8 : int(int16_t(p[0] | (p[1] << 8)));
+    };
+
+    // Linear resampling to AUDIO_RATE; a straight copy when rates match
+    int frames = int((long long)sourceFrames * AUDIO_RATE / int(rate));
+    buffer.samples.resize(size_t(frames) * 2);
+    for (int frame = 0; frame < frames; frame++) {
+        long long position = (long long)frame * int(rate);
+        int index = int(position / AUDIO_RATE);
+        int fraction = int(position % AUDIO_RATE);
+        int nextIndex = std::min(index + 1, sourceFrames - 1);
+        for (int channel = 0; channel < 2; channel++) {
+            int a = sample(index, channel);
+            int b = sample(nextIndex, channel);
+            buffer.samples[size_t(frame) * 2 + channel] = int16_t(a + (long long)(b - a) * fraction / AUDIO_RATE);
+        }
+    }
+    return true;
+}
+
+bool SoundQueue::push(const Command& command) {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    if (t - head.load(std::memory_order_acquire) == CAPACITY) return false;
+    commands[t % CAPACITY] = command;
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+}
+
+bool SoundQueue::pop(Command& command) {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    if (h == tail.load(std::memory_order_acquire)) return false;
+    command = commands[h % CAPACITY];
+    head.store(h + 1, std::memory_order_release);
+    return true;
+}
+
+// Where mixed blocks go. write() may block the mixer thread until the
+// device has room, which is what paces mixing.
+class AudioBackend {
+public:
+    virtual ~AudioBackend() {}
+    virtual const char* name() const = 0;
+    virtual bool write(const int16_t* samples, int frames) = 0;
+    // Called when mixing picks up again after the mixer slept
+    virtual void resume() {}
+};
+
+// Plays nothing, but takes blocks at the rate a device would.
+class NullBackend : public AudioBackend {
+public:
+    NullBackend() : next(std::chrono::steady_clock::now()) {}
+
+    const char* name() const override { return "null"; }
+
+    bool write(const int16_t* samples, int frames) override {
+        next += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(double(frames) / AUDIO_RATE));
+        std::this_thread::sleep_until(next);
+        return true;
+    }
+
+    void resume() override { next = std::chrono::steady_clock::now(); }
+
+private:
+    std::chrono::steady_clock::time_point next;
+};
+
+#ifdef RUNNER_OPENAL
+// Streams blocks through a handful of queued buffers on one source, which
+// keeps device latency to BUFFERS blocks.
+class OpenALBackend : public AudioBackend {
+public:
+    static const int BUFFERS = 3;
+
+    ~OpenALBackend() override {
+        if (context) {
+            alSourceStop(source);
+            alDeleteSources(1, &source);
+            alDeleteBuffers(BUFFERS, buffers);
+            alcMakeContextCurrent(nullptr);
+            alcDestroyContext(context);
+        }
+        if (device) alcCloseDevice(device);
+    }
+
+    bool open() {
+        device = alcOpenDevice(nullptr);
+        if (!device) return false;
+        context = alcCreateContext(device, nullptr);
+        if (!context || !alcMakeContextCurrent(context)) return false;
+        alGenSources(1, &source);
+        alGenBuffers(BUFFERS, buffers);
+        return alGetError() == AL_NO_ERROR;
+    }
+
+    const char* name() const override { return "OpenAL"; }
+
+    bool write(const int16_t* samples, int frames) override {
+        ALuint buffer;
+        if (queued < BUFFERS) {
+            buffer = buffers[queued++];
+        } else {
+            // Wait for the device to finish a block
+            ALint processed = 0;
+            for (;;) {
+                alGetSourcei(source, AL_BUFFERS_PROCESSED, &processed);
+                if (processed > 0) break;
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            alSourceUnqueueBuffers(source, 1, &buffer);
+        }
+        alBufferData(buffer, AL_FORMAT_STEREO16, samples, frames * 2 * int(sizeof(int16_t)), AUDIO_RATE);
+        alSourceQueueBuffers(source, 1, &buffer);
+
+        // Starts playback, and restarts it after an underrun
+        ALint state;
+        alGetSourcei(source, AL_SOURCE_STATE, &state);
+        if (state != AL_PLAYING) alSourcePlay(source);
+        return alGetError() == AL_NO_ERROR;
+    }
+
+private:
+    ALCdevice* device = nullptr;
+    ALCcontext* context = nullptr;
+    ALuint source = 0;
+    ALuint buffers[BUFFERS] = {};
+    int queued = 0;
+};
+#endif
+
+AudioEngine::AudioEngine() {}
+
+AudioEngine::~AudioEngine() {
+    stop();
+}
+
+bool AudioEngine::start(const char* directory, bool mute) {
+    stop();
+    bool loaded = true;
+    for (int i = 0; i < SOUND_COUNT; i++) {
+        std::string path = std::string(directory) + SOUND_FILES[i];
+        if (!decodeWav(path.c_str(), sounds[i])) {
+            fprintf(stderr, "Could not load sound %s\n", path.c_str());
+            sounds[i].samples.clear();
+            loaded = false;
+        }
+    }
+
+    backend.reset();
+#ifdef RUNNER_OPENAL
+    if (!mute) {
+        std::unique_ptr<OpenALBackend> device(new OpenALBackend);
+        if (device->open()) {
+            backend = std::move(device);
+        } else {
+            fprintf(stderr, "No audio device; sound is off\n");
+        }
+    }
+#endif
+    if (!backend) {
+        backend.reset(new NullBackend);
+    }
+
+    stopping = false;
+    thread = std::thread(&AudioEngine::mixLoop, this);
+    return loaded;
+}
+
+void AudioEngine::stop() {
+    if (!thread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    thread.join();
+}
+
+void AudioEngine::setIdle(bool value) {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        idle = value;
+    }
+    wake.notify_one();
+}
+
+void AudioEngine::play(SoundId sound, float gain) {
+    if (!queue.push({uint8_t(sound), gain})) {
+        droppedCount++;
+    }
+}
+
+const char* AudioEngine::backendName() const {
+    return backend ? backend->name() : "none";
+}
+
+void AudioEngine::mixLoop() {
+    int16_t block[AUDIO_BLOCK_FRAMES * 2];
+    while (!stopping) {
+        mixBlock(block);
+        if (!backend->write(block, AUDIO_BLOCK_FRAMES)) {
+            fprintf(stderr, "Audio output failed; sound is off\n");
+            return;
+        }
+        blockCount.fetch_add(1, std::memory_order_relaxed);
+
+        bool silent = true;
+        for (const Voice& voice : voices) {
+            silent = silent && voice.sound < 0;
+        }
+        if (silent && idle) {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wake.wait(lock, [this] { return stopping || !idle; });
+            backend->resume();
+        }
+    }
+}
+
+void AudioEngine::mixBlock(int16_t* out) {
+    // Start everything requested since the last block, each on a free voice
+    // or the one that has played longest
+    SoundQueue::Command command;
+    while (queue.pop(command)) {
+        if (command.sound >= SOUND_COUNT || sounds[command.sound].samples.empty()) continue;
+        Voice* voice = &voices[0];
+        for (Voice& candidate : voices) {
+            if (candidate.sound < 0) {
+                voice = &candidate;
+                break;
+            }
+            if (candidate.started < voice->started) voice = &candidate;
+        }
+        voice->sound = command.sound;
+        voice->frame = 0;
+        voice->gain = int(std::max(0.0f, std::min(command.gain, 4.0f)) * 256);
+        voice->started = voiceCounter++;
+        playedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    int mix[AUDIO_BLOCK_FRAMES * 2] = {};
+    for (Voice& voice : voices) {
+        if (voice.sound < 0) continue;
+        const SoundBuffer& sound = sounds[voice.sound];
+        int frames = std::min(AUDIO_BLOCK_FRAMES, sound.frames() - voice.frame);
+        const int16_t* samples = sound.samples.data() + size_t(voice.frame) * 2;
+        for (int i = 0; i < frames * 2; i++) {
+            mix[i] += (samples[i] * voice.gain) >> 8;
+        }
+        voice.frame += frames;
+        if (voice.frame >= sound.frames()) {
+            voice.sound = -1;
+        }
+    }
+    for (int i = 0; i < AUDIO_BLOCK_FRAMES * 2; i++) {
+        out[i] = int16_t(std::max(-32768, std::min(mix[i], 32767)));
+    }
+}
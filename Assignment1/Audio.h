@@ -0,0 +1,115 @@
+#ifndef AUDIO_H
+#define AUDIO_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+enum SoundId {
+    SOUND_JUMP,
+    SOUND_COLLISION,
+    SOUND_COLLECT,
+    SOUND_LOSE,
+    SOUND_WIN,
+    SOUND_COUNT
+};
+
+// Everything is mixed to 16-bit stereo at this rate
+const int AUDIO_RATE = 44100;
+// Frames mixed per block; about 6 ms
+const int AUDIO_BLOCK_FRAMES = 256;
+// Sounds playing at once; a new one beyond this replaces the oldest
+const int AUDIO_VOICES = 16;
+
+// A decoded sound, interleaved stereo at AUDIO_RATE.
+struct SoundBuffer {
+    std::vector<int16_t> samples;
+    int frames() const { return int(samples.size() / 2); }
+};
+
+// Reads a PCM WAV file (8 or 16 bit, mono or stereo, any rate) into buffer.
+bool decodeWav(const char* path, SoundBuffer& buffer);
+
+// Single-producer, single-consumer ring of play requests. push() and pop()
+// never lock or wait, so triggering a sound cannot stall the game loop.
+class SoundQueue {
+public:
+    static const uint32_t CAPACITY = 64; // Power of two
+
+    struct Command {
+        uint8_t sound;
+        float gain;
+    };
+
+    bool push(const Command& command);
+    bool pop(Command& command);
+
+private:
+    Command commands[CAPACITY];
+    alignas(64) std::atomic<uint32_t> head{0}; // Next to pop; written by the consumer
+    alignas(64) std::atomic<uint32_t> tail{0}; // Next to push; written by the producer
+};
+
+class AudioBackend;
+
+// Plays the game's sound effects. Every WAV is decoded into memory once by
+// start(); after that play() only posts to a lock-free queue, and a
+// dedicated thread mixes active sounds block by block and hands each block
+// to the output device. Without a device (or when muted) the null backend
+// consumes blocks at the same pace and discards them.
+class AudioEngine {
+public:
+    AudioEngine();
+    ~AudioEngine();
+
+    // Loads SOUND_COUNT sounds from directory (with trailing separator, or
+    // empty for the working directory) and starts mixing. Sounds that fail
+    // to load stay silent; returns false if any did.
+    bool start(const char* directory, bool mute);
+    void stop();
+
+    // Callable from one thread only (the game loop). Drops the request if the
+    // mixer has fallen a whole queue behind.
+    void play(SoundId sound, float gain = 1.0f);
+
+    // While idle, the mixer thread sleeps as soon as every playing sound has
+    // finished, instead of mixing silence, until idle is cleared. Sounds
+    // played while it sleeps start on wake-up.
+    void setIdle(bool idle);
+
+    const char* backendName() const;
+    long long played() const { return playedCount.load(std::memory_order_relaxed); }
+    long long dropped() const { return droppedCount; }
+    long long blocksMixed() const { return blockCount.load(std::memory_order_relaxed); }
+
+private:
+    struct Voice {
+        int sound = -1; // -1 when free
+        int frame = 0;
+        int gain = 0;   // 1/256ths
+        long long started = 0;
+    };
+
+    void mixLoop();
+    void mixBlock(int16_t* out);
+
+    SoundBuffer sounds[SOUND_COUNT];
+    SoundQueue queue;
+    Voice voices[AUDIO_VOICES];
+    long long voiceCounter = 0;
+    std::unique_ptr<AudioBackend> backend;
+    std::thread thread;
+    std::atomic<bool> stopping{false};
+    std::atomic<bool> idle{false};
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    std::atomic<long long> playedCount{0};
+    std::atomic<long long> blockCount{0};
+    long long droppedCount = 0;
+};
+
+#endif
@@ -0,0 +1,116 @@
+#include "GLIncludes.h"
+#include "BatchRenderer.h"
+
+static size_t upload(const std::vector<Vertex>& vertices, size_t offset) {
+    size_t bytes = vertices.size() * sizeof(Vertex);
+    if (bytes > 0) {
+        glBufferSubData(GL_ARRAY_BUFFER, offset, bytes, vertices.data());
+    }
+    return offset + bytes;
+}
+
+// Writes every list into the bound buffer back to back.
+static void uploadAll(const DrawBatch& batch) {
+    size_t offset = 0;
+    offset = upload(batch.triangles, offset);
+    offset = upload(batch.lines, offset);
+    offset = upload(batch.wideLines, offset);
+    upload(batch.points, offset);
+}
+
+static void countLists(const DrawBatch& batch, int counts[4]) {
+    counts[0] = int(batch.triangles.size());
+    counts[1] = int(batch.lines.size());
+    counts[2] = int(batch.wideLines.size());
+    counts[3] = int(batch.points.size());
+}
+
+static void drawList(GLenum mode, int count, GLint& first) {
+    if (count > 0) {
+        glDrawArrays(mode, first, count);
+    }
+    first += count;
+}
+
+// Draws the bound buffer as uploadAll() laid it out; counts are the
+// triangle, line, wide line and point vertex counts.
+static void drawBuffer(const int counts[4]) {
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(2, GL_FLOAT, sizeof(Vertex), (const void*)offsetof(Vertex, x));
+    glColorPointer(4, GL_FLOAT, sizeof(Vertex), (const void*)offsetof(Vertex, r));
+
+    // Translucent shapes (glow, field lines, shine) carry their alpha per
+    // vertex; opaque ones have alpha 1 and are unaffected by blending.
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    GLint first = 0;
+    drawList(GL_TRIANGLES, counts[0], first);
+    drawList(GL_LINES, counts[1], first);
+    glLineWidth(2.0f);
+    drawList(GL_LINES, counts[2], first);
+    glLineWidth(1.0f);
+    glPointSize(3.0f);
+    drawList(GL_POINTS, counts[3], first);
+
+    glDisable(GL_BLEND);
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void BatchRenderer::draw(const DrawBatch& batch) {
+    if (coreProfileActive()) {
+        core.upload(batch, true);
+        core.draw(0, 0);
+        return;
+    }
+    size_t bytes = batch.vertexCount() * sizeof(Vertex);
+    if (bytes == 0) return;
+
+    if (buffer == 0) {
+        glGenBuffers(1, &buffer);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+
+    // Orphan last frame's storage so the upload never waits on the GPU
+    if (bytes > capacity) {
+        capacity = bytes * 2;
+    }
+    glBufferData(GL_ARRAY_BUFFER, capacity, nullptr, GL_STREAM_DRAW);
+    uploadAll(batch);
+
+    int counts[4];
+    countLists(batch, counts);
+    drawBuffer(counts);
+}
+
+void StaticBatch::upload(const DrawBatch& batch) {
+    if (coreProfileActive()) {
+        core.upload(batch, false);
+        return;
+    }
+    if (buffer == 0) {
+        glGenBuffers(1, &buffer);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glBufferData(GL_ARRAY_BUFFER, batch.vertexCount() * sizeof(Vertex), nullptr, GL_STATIC_DRAW);
+    uploadAll(batch);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    countLists(batch, counts);
+}
+
+void StaticBatch::draw(float dx, float dy) const {
+    if (coreProfileActive()) {
+        core.draw(dx, dy);
+        return;
+    }
+    if (buffer == 0) return;
+
+    glPushMatrix();
+    glTranslatef(dx, dy, 0);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    drawBuffer(counts);
+    glPopMatrix();
+}
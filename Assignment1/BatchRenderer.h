@@ -0,0 +1,37 @@
+#ifndef BATCH_RENDERER_H
+#define BATCH_RENDERER_H
+
+#include "CoreProfile.h"
+#include "DrawBatch.h"
+#include <cstddef>
+
+// Draws a DrawBatch through a single streaming vertex buffer: the whole frame
+// is uploaded once and every primitive list is one glDrawArrays call, so the
+// draw-call count per frame stays constant however many objects are on screen.
+// Under the core profile it draws through a CoreBatch instead.
+class BatchRenderer {
+public:
+    void draw(const DrawBatch& batch);
+
+private:
+    unsigned int buffer = 0;
+    size_t capacity = 0;
+    CoreBatch core;
+};
+
+// A DrawBatch uploaded once into a buffer of its own, for geometry that never
+// changes (the background layers). Drawing it again costs the same handful of
+// calls and no upload; (dx, dy) shifts it, which is how layers scroll.
+class StaticBatch {
+public:
+    // Needs a current GL context.
+    void upload(const DrawBatch& batch);
+    void draw(float dx, float dy) const;
+
+private:
+    unsigned int buffer = 0;
+    int counts[4] = {};
+    CoreBatch core;
+};
+
+#endif
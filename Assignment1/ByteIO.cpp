@@ -0,0 +1,23 @@
+#include "ByteIO.h"
+#include <cstdio>
+
+bool readFile(const char* path, std::vector<uint8_t>& data) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+    data.clear();
+    uint8_t buffer[4096];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        data.insert(data.end(), buffer, buffer + read);
+    }
+    bool ok = !ferror(file);
+    fclose(file);
+    return ok;
+}
+
+bool writeFile(const char* path, const std::vector<uint8_t>& data) {
+    FILE* file = fopen(path, "wb");
+    if (!file) return false;
+    bool ok = fwrite(data.data(), 1, data.size(), file) == data.size();
+    return fclose(file) == 0 && ok;
+}
@@ -0,0 +1,81 @@
+#ifndef BYTE_IO_H
+#define BYTE_IO_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Little-endian helpers shared by the binary file formats (replays, levels).
+
+inline void putUnsigned(std::vector<uint8_t>& out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        out.push_back(uint8_t(value >> (8 * i)));
+    }
+}
+
+inline void putVarint(std::vector<uint8_t>& out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back(uint8_t(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(uint8_t(value));
+}
+
+inline void putFloat(std::vector<uint8_t>& out, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    putUnsigned(out, bits, 4);
+}
+
+inline void putDouble(std::vector<uint8_t>& out, double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    putUnsigned(out, bits, 8);
+}
+
+// Reads from a byte buffer, failing (rather than overrunning) on truncation
+struct ByteReader {
+    const std::vector<uint8_t>& data;
+    size_t pos = 0;
+
+    bool getUnsigned(uint64_t& value, int bytes) {
+        if (pos + bytes > data.size()) return false;
+        value = 0;
+        for (int i = 0; i < bytes; i++) {
+            value |= uint64_t(data[pos++]) << (8 * i);
+        }
+        return true;
+    }
+
+    bool getVarint(uint32_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            if (pos >= data.size()) return false;
+            uint8_t byte = data[pos++];
+            value |= uint32_t(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+
+    bool getFloat(float& value) {
+        uint64_t bits;
+        if (!getUnsigned(bits, 4)) return false;
+        uint32_t narrow = uint32_t(bits);
+        memcpy(&value, &narrow, sizeof(value));
+        return true;
+    }
+
+    bool getDouble(double& value) {
+        uint64_t bits;
+        if (!getUnsigned(bits, 8)) return false;
+        memcpy(&value, &bits, sizeof(value));
+        return true;
+    }
+};
+
+// Whole-file reads and writes; false on any I/O error.
+bool readFile(const char* path, std::vector<uint8_t>& data);
+bool writeFile(const char* path, const std::vector<uint8_t>& data);
+
+#endif
@@ -0,0 +1,386 @@
+#include "GLIncludes.h"
+#include "CoreProfile.h"
+#include "TextRenderer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+
+static const char* BATCH_VERTEX_SHADER = R"(#version 330 core
+layout(location = 0) in vec2 position;
+layout(location = 1) in vec4 color;
+uniform vec2 offset;
+uniform vec2 viewScale;
+uniform float pointSize;
+out vec4 vertexColor;
+void main() {
+    gl_Position = vec4((position + offset) * viewScale - 1.0, 0.0, 1.0);
+    gl_PointSize = pointSize;
+    vertexColor = color;
+}
+)";
+
+static const char* BATCH_FRAGMENT_SHADER = R"(#version 330 core
+in vec4 vertexColor;
+out vec4 fragColor;
+void main() {
+    fragColor = vertexColor;
+}
+)";
+
+// Shapes are laid out in their own units: discs and pentagons have radius
+// 1; hearts are in HEART_OUTLINE units (tip at y = -17, lobes up to about
+// y = 12, x within +-17), scaled by size.
+static const char* SHAPE_VERTEX_SHADER = R"(#version 330 core
+layout(location = 0) in vec2 corner;
+layout(location = 1) in vec2 center;
+layout(location = 2) in float size;
+layout(location = 3) in uint kind;
+layout(location = 4) in vec4 color;
+uniform vec2 offset;
+uniform vec2 viewScale;
+uniform vec2 pixelSize;
+out vec2 local;
+flat out uint shapeKind;
+out vec4 shapeColor;
+void main() {
+    // Room for the shape plus a pixel of anti-aliased edge
+    float extent = kind >= 2u ? 18.0 : 1.0;
+    local = corner * (extent + pixelSize / size);
+    gl_Position = vec4((center + offset + local * size) * viewScale - 1.0, 0.0, 1.0);
+    shapeKind = kind;
+    shapeColor = color;
+}
+)";
+
+static const char* SHAPE_FRAGMENT_SHADER = R"(#version 330 core
+in vec2 local;
+flat in uint shapeKind;
+in vec4 shapeColor;
+out vec4 fragColor;
+
+float lengthSquared(vec2 v) {
+    return dot(v, v);
+}
+
+// Regular pentagon with inradius r and a flat edge on top
+float pentagonDistance(vec2 p, float r) {
+    const vec3 k = vec3(0.809016994, 0.587785252, 0.726542528);
+    p.x = abs(p.x);
+    p -= 2.0 * min(dot(vec2(-k.x, k.y), p), 0.0) * vec2(-k.x, k.y);
+    p -= 2.0 * min(dot(vec2(k.x, k.y), p), 0.0) * vec2(k.x, k.y);
+    p -= vec2(clamp(p.x, -r * k.z, r * k.z), r);
+    return length(p) * sign(p.y);
+}
+
+// Heart of two arcs and two lines, tip at the origin and about 1.2 wide
+float heartDistance(vec2 p) {
+    p.x = abs(p.x);
+    if (p.y + p.x > 1.0) {
+        return sqrt(lengthSquared(p - vec2(0.25, 0.75))) - sqrt(2.0) / 4.0;
+    }
+    return sqrt(min(lengthSquared(p - vec2(0.0, 1.0)), lengthSquared(p - 0.5 * max(p.x + p.y, 0.0)))) *
+           sign(p.x - p.y);
+}
+
+void main() {
+    float distance;
+    if (shapeKind == 0u) {
+        distance = length(local) - 1.0;
+    } else if (shapeKind == 1u) {
+        // Corner along +x, as the coin's star is laid out; inradius cos 36
+        distance = pentagonDistance(vec2(local.y, -local.x), 0.809016994);
+    } else {
+        // Fitted to the parametric outline: tip at y = -17, 33 units wide
+        const float SCALE = 26.5;
+        distance = heartDistance((local - vec2(0.0, -17.0)) / SCALE) * SCALE;
+    }
+    // Distance in pixels from how fast it changes across the screen
+    float pixel = max(fwidth(distance), 1e-6);
+    if (shapeKind == 3u) {
+        distance = abs(distance) - 0.5 * pixel;
+    }
+    float coverage = clamp(0.5 - distance / pixel, 0.0, 1.0);
+    if (coverage <= 0.0) {
+        discard;
+    }
+    fragColor = vec4(shapeColor.rgb, shapeColor.a * coverage);
+}
+)";
+
+static const char* TEXT_VERTEX_SHADER = R"(#version 330 core
+layout(location = 0) in vec2 position;
+layout(location = 1) in vec2 uv;
+layout(location = 2) in vec4 color;
+uniform vec2 viewScale;
+out vec2 atlasPosition;
+out vec4 textColor;
+void main() {
+    gl_Position = vec4(position * viewScale - 1.0, 0.0, 1.0);
+    atlasPosition = uv;
+    textColor = color;
+}
+)";
+
+static const char* TEXT_FRAGMENT_SHADER = R"(#version 330 core
+in vec2 atlasPosition;
+in vec4 textColor;
+uniform sampler2D atlas;
+out vec4 fragColor;
+void main() {
+    fragColor = vec4(textColor.rgb, textColor.a * texture(atlas, atlasPosition).r);
+}
+)";
+
+struct Program {
+    GLuint id = 0;
+    GLint offset = -1;
+    GLint viewScale = -1;
+    GLint pointSize = -1;
+    GLint pixelSize = -1;
+};
+
+static bool active = false;
+static Program batchProgram;
+static Program shapeProgram;
+static Program textProgram;
+static GLuint cornerBuffer = 0; // Unit quad the shape instances are stretched over
+static GLuint textArray = 0;
+static GLuint textBuffer = 0;
+static size_t textCapacity = 0;
+static float viewScaleX = 2.0f / 800, viewScaleY = 2.0f / 600;
+static float pixelWidth = 1, pixelHeight = 1; // View units per pixel
+
+static GLuint compile(GLenum type, const char* source) {
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+    GLint ok = 0;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+    if (!ok) {
+        char log[2048];
+        glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+        fprintf(stderr, "Shader did not compile:\n%s\n", log);
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+static bool link(Program& program, const char* vertexSource, const char* fragmentSource) {
+    GLuint vertex = compile(GL_VERTEX_SHADER, vertexSource);
+    GLuint fragment = compile(GL_FRAGMENT_SHADER, fragmentSource);
+    if (!vertex || !fragment) return false;
+
+    program.id = glCreateProgram();
+    glAttachShader(program.id, vertex);
+    glAttachShader(program.id, fragment);
+    glLinkProgram(program.id);
+    glDeleteShader(vertex);
+    glDeleteShader(fragment);
+    GLint ok = 0;
+    glGetProgramiv(program.id, GL_LINK_STATUS, &ok);
+    if (!ok) {
+        char log[2048];
+        glGetProgramInfoLog(program.id, sizeof(log), nullptr, log);
+        fprintf(stderr, "Shader program did not link:\n%s\n", log);
+        return false;
+    }
+    program.offset = glGetUniformLocation(program.id, "offset");
+    program.viewScale = glGetUniformLocation(program.id, "viewScale");
+    program.pointSize = glGetUniformLocation(program.id, "pointSize");
+    program.pixelSize = glGetUniformLocation(program.id, "pixelSize");
+    return true;
+}
+
+bool initCoreProfile() {
+    if (!link(batchProgram, BATCH_VERTEX_SHADER, BATCH_FRAGMENT_SHADER) ||
+        !link(shapeProgram, SHAPE_VERTEX_SHADER, SHAPE_FRAGMENT_SHADER) ||
+        !link(textProgram, TEXT_VERTEX_SHADER, TEXT_FRAGMENT_SHADER)) {
+        return false;
+    }
+
+    const float corners[] = {-1, -1, 1, -1, -1, 1, 1, 1};
+    glGenBuffers(1, &cornerBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, cornerBuffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+
+    glGenVertexArrays(1, &textArray);
+    glGenBuffers(1, &textBuffer);
+    glBindVertexArray(textArray);
+    glBindBuffer(GL_ARRAY_BUFFER, textBuffer);
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (const void*)offsetof(TextVertex, x));
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (const void*)offsetof(TextVertex, u));
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (const void*)offsetof(TextVertex, r));
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glEnable(GL_PROGRAM_POINT_SIZE);
+    active = true;
+    return true;
+}
+
+bool coreProfileActive() {
+    return active;
+}
+
+void setCoreView(float viewWidth, float viewHeight, int width, int height) {
+    glViewport(0, 0, width, height);
+    viewScaleX = 2.0f / viewWidth;
+    viewScaleY = 2.0f / viewHeight;
+    pixelWidth = viewWidth / std::max(width, 1);
+    pixelHeight = viewHeight / std::max(height, 1);
+}
+
+static void useProgram(const Program& program, float dx, float dy) {
+    glUseProgram(program.id);
+    glUniform2f(program.offset, dx, dy);
+    glUniform2f(program.viewScale, viewScaleX, viewScaleY);
+    if (program.pixelSize >= 0) {
+        glUniform2f(program.pixelSize, pixelWidth, pixelHeight);
+    }
+}
+
+// Two triangles covering a 2 px wide band along the segment from a to b.
+static void appendWideLine(std::vector<Vertex>& out, const Vertex& a, const Vertex& b) {
+    // Perpendicular in pixels, then back to view units
+    float px = (b.x - a.x) / pixelWidth;
+    float py = (b.y - a.y) / pixelHeight;
+    float length = std::sqrt(px * px + py * py);
+    if (length == 0) return;
+    float nx = -py / length * pixelWidth;
+    float ny = px / length * pixelHeight;
+
+    Vertex a0 = a, a1 = a, b0 = b, b1 = b;
+    a0.x -= nx; a0.y -= ny;
+    a1.x += nx; a1.y += ny;
+    b0.x -= nx; b0.y -= ny;
+    b1.x += nx; b1.y += ny;
+    const Vertex quad[6] = {a0, b0, b1, a0, b1, a1};
+    out.insert(out.end(), quad, quad + 6);
+}
+
+// Grows buffer (bound to GL_ARRAY_BUFFER) to hold bytes, orphaning the old
+// storage when streaming so the upload never waits on the GPU.
+static void reserve(size_t bytes, size_t& capacity, bool stream) {
+    if (bytes > capacity || stream) {
+        capacity = std::max(capacity, stream ? bytes * 2 : bytes);
+        glBufferData(GL_ARRAY_BUFFER, capacity, nullptr, stream ? GL_STREAM_DRAW : GL_STATIC_DRAW);
+    }
+}
+
+void CoreBatch::upload(const DrawBatch& batch, bool stream) {
+    if (vertexArray == 0) {
+        glGenVertexArrays(1, &vertexArray);
+        glGenVertexArrays(1, &shapeArray);
+        glGenBuffers(1, &buffer);
+        glGenBuffers(1, &shapeBuffer);
+
+        glBindVertexArray(vertexArray);
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glEnableVertexAttribArray(0);
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)offsetof(Vertex, x));
+        glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)offsetof(Vertex, r));
+
+        glBindVertexArray(shapeArray);
+        glBindBuffer(GL_ARRAY_BUFFER, cornerBuffer);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+        glBindBuffer(GL_ARRAY_BUFFER, shapeBuffer);
+        for (int attribute = 1; attribute <= 4; attribute++) {
+            glEnableVertexAttribArray(attribute);
+            glVertexAttribDivisor(attribute, 1);
+        }
+        GLsizei stride = sizeof(ShapeInstance);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (const void*)offsetof(ShapeInstance, x));
+        glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, stride, (const void*)offsetof(ShapeInstance, size));
+        glVertexAttribIPointer(3, 1, GL_UNSIGNED_INT, stride, (const void*)offsetof(ShapeInstance, kind));
+        glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, stride, (const void*)offsetof(ShapeInstance, r));
+        glBindVertexArray(0);
+    }
+
+    vertices.clear();
+    vertices.insert(vertices.end(), batch.triangles.begin(), batch.triangles.end());
+    vertices.insert(vertices.end(), batch.lines.begin(), batch.lines.end());
+    for (size_t i = 0; i + 1 < batch.wideLines.size(); i += 2) {
+        appendWideLine(vertices, batch.wideLines[i], batch.wideLines[i + 1]);
+    }
+    size_t pointsStart = vertices.size();
+    vertices.insert(vertices.end(), batch.points.begin(), batch.points.end());
+    counts[0] = int(batch.triangles.size());
+    counts[1] = int(batch.lines.size());
+    counts[2] = int(pointsStart) - counts[0] - counts[1];
+    counts[3] = int(batch.points.size());
+    shapeCount = int(batch.shapes.size());
+
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    reserve(vertices.size() * sizeof(Vertex), capacity, stream);
+    if (!vertices.empty()) {
+        glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(Vertex), vertices.data());
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, shapeBuffer);
+    reserve(batch.shapes.size() * sizeof(ShapeInstance), shapeCapacity, stream);
+    if (shapeCount > 0) {
+        glBufferSubData(GL_ARRAY_BUFFER, 0, batch.shapes.size() * sizeof(ShapeInstance), batch.shapes.data());
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void CoreBatch::draw(float dx, float dy) const {
+    if (vertexArray == 0) return;
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    useProgram(batchProgram, dx, dy);
+    glUniform1f(batchProgram.pointSize, 1.0f);
+    glBindVertexArray(vertexArray);
+    if (counts[0] > 0) glDrawArrays(GL_TRIANGLES, 0, counts[0]);
+
+    if (shapeCount > 0) {
+        useProgram(shapeProgram, dx, dy);
+        glBindVertexArray(shapeArray);
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, shapeCount);
+        useProgram(batchProgram, dx, dy);
+        glBindVertexArray(vertexArray);
+    }
+
+    int first = counts[0];
+    if (counts[1] > 0) glDrawArrays(GL_LINES, first, counts[1]);
+    first += counts[1];
+    if (counts[2] > 0) glDrawArrays(GL_TRIANGLES, first, counts[2]);
+    first += counts[2];
+    if (counts[3] > 0) {
+        glUniform1f(batchProgram.pointSize, 3.0f);
+        glDrawArrays(GL_POINTS, first, counts[3]);
+    }
+
+    glBindVertexArray(0);
+    glUseProgram(0);
+    glDisable(GL_BLEND);
+}
+
+void drawCoreText(unsigned int texture, const TextVertex* vertices, int count) {
+    if (count == 0) return;
+
+    glBindBuffer(GL_ARRAY_BUFFER, textBuffer);
+    reserve(count * sizeof(TextVertex), textCapacity, true);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(TextVertex), vertices);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    useProgram(textProgram, 0, 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glBindVertexArray(textArray);
+    glDrawArrays(GL_TRIANGLES, 0, count);
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glUseProgram(0);
+    glDisable(GL_BLEND);
+}
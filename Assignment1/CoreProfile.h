@@ -0,0 +1,50 @@
+#ifndef CORE_PROFILE_H
+#define CORE_PROFILE_H
+
+#include "DrawBatch.h"
+#include <vector>
+
+// Optional OpenGL 3.3 core-profile rendering (--core-profile). A core
+// context has no fixed-function pipeline, matrix stack or client-side
+// arrays, so once initCoreProfile() has succeeded BatchRenderer, StaticBatch
+// and TextRenderer draw through the shader programs built here. Round shapes
+// in a batch (DrawBatch::shapes) are drawn as one instanced quad each, whose
+// fragment shader evaluates the shape's signed distance and anti-aliases
+// the edge over one pixel at any window size.
+
+// Builds the programs; needs the core context current. Returns false, with
+// the compiler or linker log on stderr, if any fails.
+bool initCoreProfile();
+bool coreProfileActive();
+
+// The core counterpart of glViewport plus gluOrtho2D(0, viewWidth, 0,
+// viewHeight) on a pixelWidth x pixelHeight window.
+void setCoreView(float viewWidth, float viewHeight, int pixelWidth, int pixelHeight);
+
+// One DrawBatch in GL buffers, drawn in the order triangles, shapes, lines,
+// 2 px lines and points. Core contexts may not draw lines wider than 1 px,
+// so wide lines become thin quads at upload, sized for the view at the time.
+class CoreBatch {
+public:
+    // Replaces the contents. stream marks data replaced every frame.
+    void upload(const DrawBatch& batch, bool stream);
+    void draw(float dx, float dy) const;
+
+private:
+    unsigned int vertexArray = 0;
+    unsigned int shapeArray = 0;
+    unsigned int buffer = 0;
+    unsigned int shapeBuffer = 0;
+    size_t capacity = 0;
+    size_t shapeCapacity = 0;
+    int counts[4] = {}; // Triangle, line, wide line triangle and point vertices
+    int shapeCount = 0;
+    std::vector<Vertex> vertices; // Upload scratch
+};
+
+struct TextVertex;
+
+// Draws count text vertices (triangles) from a single-channel atlas texture.
+void drawCoreText(unsigned int texture, const TextVertex* vertices, int count);
+
+#endif
@@ -0,0 +1,96 @@
+#include "DrawBatch.h"
+
+static void appendTranslated(std::vector<Vertex>& out, const std::vector<Vertex>& in, float dx, float dy) {
+    for (const Vertex& v : in) {
+        out.push_back({v.x + dx, v.y + dy, v.r, v.g, v.b, v.a});
+    }
+}
+
+void DrawBatch::clear() {
+    triangles.clear();
+    lines.clear();
+    wideLines.clear();
+    points.clear();
+    shapes.clear();
+}
+
+void DrawBatch::append(const DrawBatch& mesh, float dx, float dy) {
+    appendTranslated(triangles, mesh.triangles, dx, dy);
+    appendTranslated(lines, mesh.lines, dx, dy);
+    appendTranslated(wideLines, mesh.wideLines, dx, dy);
+    appendTranslated(points, mesh.points, dx, dy);
+    for (const ShapeInstance& shape : mesh.shapes) {
+        shapes.push_back({shape.x + dx, shape.y + dy, shape.size, shape.kind, shape.r, shape.g, shape.b, shape.a});
+    }
+}
+
+int DrawBatch::vertexCount() const {
+    return int(triangles.size() + lines.size() + wideLines.size() + points.size());
+}
+
+void MeshBuilder::color(float r, float g, float b, float a) {
+    this->r = r;
+    this->g = g;
+    this->b = b;
+    this->a = a;
+}
+
+Vertex MeshBuilder::vertex(float x, float y) const {
+    return {x, y, r, g, b, a};
+}
+
+void MeshBuilder::triangle(float x1, float y1, float x2, float y2, float x3, float y3) {
+    mesh.triangles.push_back(vertex(x1, y1));
+    mesh.triangles.push_back(vertex(x2, y2));
+    mesh.triangles.push_back(vertex(x3, y3));
+}
+
+void MeshBuilder::quad(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4) {
+    triangle(x1, y1, x2, y2, x3, y3);
+    triangle(x1, y1, x3, y3, x4, y4);
+}
+
+void MeshBuilder::fan(const float* xy, int count) {
+    for (int i = 1; i + 1 < count; i++) {
+        triangle(xy[0], xy[1], xy[2*i], xy[2*i + 1], xy[2*i + 2], xy[2*i + 3]);
+    }
+}
+
+void MeshBuilder::strip(const Vertex* vertices, int count) {
+    for (int i = 0; i + 2 < count; i++) {
+        mesh.triangles.push_back(vertices[i]);
+        mesh.triangles.push_back(vertices[i + 1]);
+        mesh.triangles.push_back(vertices[i + 2]);
+    }
+}
+
+void MeshBuilder::line(float x1, float y1, float x2, float y2) {
+    mesh.lines.push_back(vertex(x1, y1));
+    mesh.lines.push_back(vertex(x2, y2));
+}
+
+void MeshBuilder::wideLine(float x1, float y1, float x2, float y2) {
+    mesh.wideLines.push_back(vertex(x1, y1));
+    mesh.wideLines.push_back(vertex(x2, y2));
+}
+
+void MeshBuilder::lineStrip(const float* xy, int count) {
+    for (int i = 0; i + 1 < count; i++) {
+        line(xy[2*i], xy[2*i + 1], xy[2*i + 2], xy[2*i + 3]);
+    }
+}
+
+void MeshBuilder::lineLoop(const float* xy, int count) {
+    lineStrip(xy, count);
+    if (count > 1) {
+        line(xy[2*count - 2], xy[2*count - 1], xy[0], xy[1]);
+    }
+}
+
+void MeshBuilder::point(float x, float y) {
+    mesh.points.push_back(vertex(x, y));
+}
+
+void MeshBuilder::shape(ShapeKind kind, float x, float y, float size) {
+    mesh.shapes.push_back({x, y, size, kind, r, g, b, a});
+}
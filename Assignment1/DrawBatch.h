@@ -0,0 +1,89 @@
+#ifndef DRAW_BATCH_H
+#define DRAW_BATCH_H
+
+#include <cstdint>
+#include <vector>
+
+struct Vertex {
+    float x, y;
+    float r, g, b, a;
+};
+
+// Round shapes that the core-profile renderer draws as one quad each, with
+// a fragment shader evaluating the shape's signed distance.
+enum ShapeKind : uint32_t {
+    SHAPE_DISC,          // Radius size
+    SHAPE_PENTAGON,      // Circumradius size, a corner pointing along +x
+    SHAPE_HEART,         // HEART_OUTLINE scaled by size
+    SHAPE_HEART_OUTLINE  // Its 1 px outline
+};
+
+struct ShapeInstance {
+    float x, y;
+    float size;
+    ShapeKind kind;
+    float r, g, b, a;
+};
+
+// CPU-side list of independent primitives, one vertex list per primitive type.
+// The same type holds a single shape (a mesh built once at startup) and a
+// whole frame (every mesh instance appended at its position), which is then
+// drawn with one call per list regardless of how many objects are on screen.
+//
+// Lists are drawn one after another, so layering goes by primitive type, not
+// by object: every fill in the batch is under every line, wide line and
+// point, and core-profile shapes are over all the fills. The double-points
+// glow therefore sits under its "2x", and coin rays and magnet field lines
+// stay visible over any object that overlaps them. The immediate-mode game
+// drew each object whole in turn; this is the trade for a fixed draw-call
+// count.
+struct DrawBatch {
+    std::vector<Vertex> triangles;
+    std::vector<Vertex> lines;
+    std::vector<Vertex> wideLines; // Drawn 2 px wide
+    std::vector<Vertex> points;    // Drawn 3 px wide
+    // Drawn after the triangles, only by the core-profile renderer; meshes
+    // meant for any other renderer tessellate their round shapes instead
+    std::vector<ShapeInstance> shapes;
+
+    // Keeps the allocated capacity so steady-state frames never allocate.
+    void clear();
+    // Appends every primitive of mesh translated by (dx, dy).
+    void append(const DrawBatch& mesh, float dx, float dy);
+    int vertexCount() const;
+};
+
+// Fills a DrawBatch the way glBegin/glEnd blocks would, converting strips,
+// fans, quads and polygons into independent triangles and lines.
+class MeshBuilder {
+public:
+    // With useShapes, callers emit round shapes through shape() rather than
+    // tessellating them.
+    explicit MeshBuilder(DrawBatch& mesh, bool useShapes = false) : mesh(mesh), useShapes(useShapes) {}
+
+    bool shapes() const { return useShapes; }
+
+    void color(float r, float g, float b, float a = 1.0f);
+    // Vertex with its own color, for gradients such as the magnet horseshoe.
+    Vertex vertex(float x, float y) const;
+
+    void triangle(float x1, float y1, float x2, float y2, float x3, float y3);
+    void quad(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4);
+    // GL_TRIANGLE_FAN / GL_POLYGON: xy holds count (x, y) pairs.
+    void fan(const float* xy, int count);
+    // GL_TRIANGLE_STRIP from explicitly colored vertices.
+    void strip(const Vertex* vertices, int count);
+    void line(float x1, float y1, float x2, float y2);
+    void wideLine(float x1, float y1, float x2, float y2);
+    void lineStrip(const float* xy, int count);
+    void lineLoop(const float* xy, int count);
+    void point(float x, float y);
+    void shape(ShapeKind kind, float x, float y, float size);
+
+private:
+    DrawBatch& mesh;
+    bool useShapes;
+    float r = 1, g = 1, b = 1, a = 1;
+};
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef ENTITY_POOL_H
+#define ENTITY_POOL_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// One game object, as handed to and read back from a pool. Hot loops work
+// on the pool's columns instead.
+struct GameObject {
+    float x, y;
+    float prevX, prevY; // Position before the last step, for render interpolation
+    uint8_t phase; // Animation phase group (see BOB_PHASES)
+    bool isHighObstacle;
+};
+
+// Fixed-capacity store of live objects, kept as one array per field
+// (structure of arrays) so movement, culling and collision kernels stream
+// through exactly the fields they need. Storage is allocated once up front;
+// killing an object moves the last live one into its slot (swap-and-pop), so
+// columns stay dense, iteration only ever visits live objects and memory
+// stays flat no matter how long a session runs.
+class EntityPool {
+public:
+    explicit EntityPool(int capacity)
+        : x(capacity), y(capacity), prevX(capacity), prevY(capacity),
+          phase(capacity), isHighObstacle(capacity), count(0) {}
+
+    // Returns false (and drops the object) when the pool is full.
+    bool spawn(const GameObject& obj) {
+        if (count == capacity()) return false;
+        x[count] = obj.x;
+        y[count] = obj.y;
+        prevX[count] = obj.prevX;
+        prevY[count] = obj.prevY;
+        phase[count] = obj.phase;
+        isHighObstacle[count] = obj.isHighObstacle;
+        count++;
+        return true;
+    }
+
+    // Removes the object at index. The last live object takes its place, so
+    // callers removing several must go from the highest index down.
+    void kill(int index) {
+        count--;
+        x[index] = x[count];
+        y[index] = y[count];
+        prevX[index] = prevX[count];
+        prevY[index] = prevY[count];
+        phase[index] = phase[count];
+        isHighObstacle[index] = isHighObstacle[count];
+    }
+
+    void clear() { count = 0; }
+
+    // Copies other's live objects over this pool's, which must have room
+    // for them all.
+    void copyFrom(const EntityPool& other) {
+        count = other.count;
+        std::copy(other.x.begin(), other.x.begin() + count, x.begin());
+        std::copy(other.y.begin(), other.y.begin() + count, y.begin());
+        std::copy(other.prevX.begin(), other.prevX.begin() + count, prevX.begin());
+        std::copy(other.prevY.begin(), other.prevY.begin() + count, prevY.begin());
+        std::copy(other.phase.begin(), other.phase.begin() + count, phase.begin());
+        std::copy(other.isHighObstacle.begin(), other.isHighObstacle.begin() + count, isHighObstacle.begin());
+    }
+
+    int size() const { return count; }
+    int capacity() const { return int(x.size()); }
+    bool empty() const { return count == 0; }
+
+    GameObject operator[](int index) const {
+        return {x[index], y[index], prevX[index], prevY[index], phase[index], isHighObstacle[index] != 0};
+    }
+
+    // Columns; only [0, size()) is live
+    std::vector<float> x, y;
+    std::vector<float> prevX, prevY;
+    std::vector<uint8_t> phase;
+    std::vector<uint8_t> isHighObstacle;
+
+private:
+    int count;
+};
+
+#endif
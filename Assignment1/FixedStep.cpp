@@ -0,0 +1,42 @@
+#include "FixedStep.h"
+
+FixedStepClock::FixedStepClock(int tickRate, int maxStepsPerFrame)
+    : tickLength(1.0 / tickRate), maxSteps(maxStepsPerFrame) {}
+
+int FixedStepClock::advance() {
+    auto now = std::chrono::steady_clock::now();
+    if (!started) {
+        started = true;
+        last = now;
+        return 0;
+    }
+    accumulator += std::chrono::duration<double>(now - last).count();
+    last = now;
+
+    int steps = 0;
+    while (accumulator >= tickLength && steps < maxSteps) {
+        accumulator -= tickLength;
+        steps++;
+    }
+    if (steps == maxSteps && accumulator >= tickLength) {
+        accumulator = 0;
+    }
+    // The newest tick fell due accumulator ago, the others a tick apart
+    // before it
+    double sinceFirst = accumulator + (steps > 0 ? steps - 1 : 0) * tickLength;
+    firstDue = now - std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                         std::chrono::duration<double>(sinceFirst));
+    return steps;
+}
+
+std::chrono::steady_clock::time_point FixedStepClock::nextTick() const {
+    if (!started) return std::chrono::steady_clock::now();
+    return last + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                      std::chrono::duration<double>(tickLength - accumulator));
+}
+
+float FixedStepClock::alpha() const {
+    if (!started) return 0;
+    double pending = accumulator + std::chrono::duration<double>(std::chrono::steady_clock::now() - last).count();
+    return pending >= tickLength ? 1.0f : float(pending / tickLength);
+}
@@ -0,0 +1,46 @@
+#ifndef FIXED_STEP_H
+#define FIXED_STEP_H
+
+#include <chrono>
+
+// Converts monotonic wall-clock time into a whole number of fixed-length
+// simulation ticks, so gameplay runs at the same speed however often (or
+// irregularly) the caller gets to run.
+class FixedStepClock {
+public:
+    // maxStepsPerFrame caps the catch-up after a long stall; time beyond it
+    // is dropped instead of making the next frame even slower.
+    explicit FixedStepClock(int tickRate, int maxStepsPerFrame = 8);
+
+    // Number of ticks owed since the previous call.
+    int advance();
+    // How far the clock is between the last tick and the next, in [0, 1].
+    // Renderers blend previous and current positions by this amount.
+    float alpha() const;
+    // Forgets the time since the last advance(), so a clock that stopped
+    // being advanced (while paused, say) resumes without owing ticks.
+    void reset() {
+        started = false;
+        accumulator = 0;
+    }
+    double tickSeconds() const { return tickLength; }
+    // When the next tick falls due; a caller with nothing else to do can
+    // sleep until then.
+    std::chrono::steady_clock::time_point nextTick() const;
+    // When the step-th (from 0) of the ticks owed by the last advance() fell
+    // due.
+    std::chrono::steady_clock::time_point tickTime(int step) const {
+        return firstDue + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                              std::chrono::duration<double>(step * tickLength));
+    }
+
+private:
+    std::chrono::steady_clock::time_point last;
+    std::chrono::steady_clock::time_point firstDue;
+    bool started = false;
+    double accumulator = 0;
+    double tickLength;
+    int maxSteps;
+};
+
+#endif
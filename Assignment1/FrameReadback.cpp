@@ -0,0 +1,68 @@
+#include "GLIncludes.h"
+#include "FrameReadback.h"
+#include <cstring>
+
+void FrameReadback::start(VideoWriter& target) {
+    writer = &target;
+    size_t bytes = size_t(target.width()) * target.height() * 4;
+    glGenBuffers(DEPTH, buffers);
+    for (int i = 0; i < DEPTH; i++) {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, buffers[i]);
+        glBufferData(GL_PIXEL_PACK_BUFFER, bytes, nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    next = 0;
+    pending = 0;
+    windowWidth = target.width();
+    windowHeight = target.height();
+}
+
+void FrameReadback::setWindowSize(int width, int height) {
+    windowWidth = width;
+    windowHeight = height;
+}
+
+void FrameReadback::capture() {
+    if (!writer) return;
+    if (windowWidth != writer->width() || windowHeight != writer->height()) {
+        writer->dropFrame();
+        return;
+    }
+    if (pending == DEPTH) {
+        deliverOldest();
+    }
+
+    // With a pack buffer bound the pointer is an offset into it, and the
+    // call only queues the copy
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, buffers[next]);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadBuffer(GL_BACK);
+    glReadPixels(0, 0, writer->width(), writer->height(), GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    next = (next + 1) % DEPTH;
+    pending++;
+}
+
+void FrameReadback::flush() {
+    while (writer && pending > 0) {
+        deliverOldest();
+    }
+}
+
+void FrameReadback::deliverOldest() {
+    int oldest = (next - pending + DEPTH) % DEPTH;
+    pending--;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, buffers[oldest]);
+    const void* pixels = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+    if (pixels) {
+        // Never waits: if the writer is a queue behind, this frame is dropped
+        uint8_t* frame = writer->nextFrame(false);
+        if (frame) {
+            memcpy(frame, pixels, size_t(writer->width()) * writer->height() * 4);
+            writer->submit();
+        }
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
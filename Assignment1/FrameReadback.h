@@ -0,0 +1,40 @@
+#ifndef FRAME_READBACK_H
+#define FRAME_READBACK_H
+
+#include "VideoWriter.h"
+
+// Copies drawn frames out of GL for a VideoWriter without stalling the
+// render thread. Each frame is read into the next of DEPTH pixel buffer
+// objects, which returns at once while the GPU copies in the background; a
+// buffer is only mapped DEPTH - 1 frames later, when its copy has long
+// finished. Frames therefore reach the writer DEPTH - 1 frames late.
+class FrameReadback {
+public:
+    static const int DEPTH = 3;
+
+    // Needs a current GL context, with the window writer.width() x
+    // writer.height() pixels.
+    void start(VideoWriter& writer);
+    bool started() const { return writer != nullptr; }
+    // Call on every reshape. Frames drawn while the window is not the
+    // capture size are counted as dropped rather than read back cropped or
+    // out of range.
+    void setWindowSize(int width, int height);
+
+    // Starts reading the frame just drawn (call before the buffer swap) and
+    // hands the oldest finished one to the writer.
+    void capture();
+    // Hands every frame still in flight to the writer, waiting for them.
+    void flush();
+
+private:
+    void deliverOldest();
+
+    VideoWriter* writer = nullptr;
+    unsigned int buffers[DEPTH] = {};
+    int next = 0;    // Buffer the next frame is read into
+    int pending = 0; // Buffers holding frames not yet delivered
+    int windowWidth = 0, windowHeight = 0;
+};
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef GL_INCLUDES_H
+#define GL_INCLUDES_H
+
+// GLUT lives in a framework on macOS and in GL/ everywhere else (freeglut on
+// Linux). Buffer object entry points are core since GL 1.5 but Mesa only
+// declares them with GL_GLEXT_PROTOTYPES. The core-profile path needs the
+// GL 3 declarations (gl3.h on macOS) and, elsewhere, freeglut's context
+// version calls when it is installed.
+#ifdef __APPLE__
+#define GL_SILENCE_DEPRECATION
+#define GL_DO_NOT_WARN_IF_MULTI_GL_VERSION_HEADERS_INCLUDED
+#include <OpenGL/gl3.h>
+#include <GLUT/glut.h>
+#else
+#define GL_GLEXT_PROTOTYPES
+#if __has_include(<GL/freeglut.h>)
+#include <GL/freeglut.h>
+#else
+#include <GL/glut.h>
+#endif
+#endif
+
+#endif
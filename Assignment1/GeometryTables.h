@@ -0,0 +1,75 @@
+#ifndef GEOMETRY_TABLES_H
+#define GEOMETRY_TABLES_H
+
+#include <array>
+
+// Unit-circle, arc and heart outlines for every round shape the game draws,
+// evaluated by the compiler so no trig runs at startup or per frame.
+
+struct Point2 {
+    float x, y;
+};
+
+constexpr double GEOMETRY_PI = 3.14159265358979323846;
+
+// Taylor series after reducing x to [-pi, pi]; accurate to well below a
+// float ulp at the handful of angles the tables use.
+constexpr double constSin(double x) {
+    double turns = x / (2 * GEOMETRY_PI);
+    long long whole = (long long)(turns < 0 ? turns - 0.5 : turns + 0.5);
+    x -= whole * 2 * GEOMETRY_PI;
+    double term = x;
+    double sum = x;
+    for (int n = 1; n < 12; n++) {
+        term *= -x * x / ((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double constCos(double x) {
+    return constSin(x + GEOMETRY_PI / 2);
+}
+
+// N points at angles 0, step, 2*step, ... on the unit circle.
+template <int N>
+constexpr std::array<Point2, N> unitArc(double step) {
+    std::array<Point2, N> points{};
+    for (int i = 0; i < N; i++) {
+        points[i] = {float(constCos(i * step)), float(constSin(i * step))};
+    }
+    return points;
+}
+
+// x = 16 sin^3 t, y = 13 cos t - 5 cos 2t - 2 cos 3t - cos 4t
+template <int N>
+constexpr std::array<Point2, N> heartOutline() {
+    std::array<Point2, N> points{};
+    for (int i = 0; i < N; i++) {
+        double t = 2 * GEOMETRY_PI * i / N;
+        double s = constSin(t);
+        points[i] = {float(16 * s * s * s),
+                     float(13 * constCos(t) - 5 * constCos(2 * t) - 2 * constCos(3 * t) - constCos(4 * t))};
+    }
+    return points;
+}
+
+const int CIRCLE_SEGMENTS = 20;
+
+// Cactus top: closed fan at 10 degree steps
+constexpr auto CACTUS_TOP = unitArc<37>(GEOMETRY_PI / 18);
+// Coin outline
+constexpr auto COIN_CIRCLE = unitArc<16>(2 * GEOMETRY_PI / 16);
+// Coin star, first point repeated at the end
+constexpr auto STAR_POINTS = unitArc<6>(2 * GEOMETRY_PI / 5);
+// Magnet horseshoe and shine, 0 to pi inclusive
+constexpr auto HALF_CIRCLE = unitArc<CIRCLE_SEGMENTS + 1>(GEOMETRY_PI / CIRCLE_SEGMENTS);
+// Double points glow, full circle with the first point repeated
+constexpr auto GLOW_CIRCLE = unitArc<CIRCLE_SEGMENTS + 1>(2 * GEOMETRY_PI / CIRCLE_SEGMENTS);
+constexpr auto HEART_OUTLINE = heartOutline<20>();
+
+static_assert(HALF_CIRCLE[CIRCLE_SEGMENTS / 2].y > 0.999999f && HALF_CIRCLE[CIRCLE_SEGMENTS / 2].y < 1.000001f,
+              "constSin lost precision");
+static_assert(HEART_OUTLINE[0].y > 4.9999f && HEART_OUTLINE[0].y < 5.0001f, "heart outline starts at the top cusp");
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef HITBOX_H
+#define HITBOX_H
+
+struct Box {
+    float minX, minY, maxX, maxY;
+};
+
+inline bool overlaps(const Box& a, const Box& b) {
+    return a.minX < b.maxX && a.maxX > b.minX && a.minY < b.maxY && a.maxY > b.minY;
+}
+
+// Hitbox of an object relative to its (x, y). Objects flagged high (tall
+// cacti) use maxDYHigh instead of maxDY.
+struct ObjectShape {
+    float minDX, maxDX;
+    float minDY, maxDY, maxDYHigh;
+};
+
+inline Box objectBox(const ObjectShape& shape, float x, float y, bool high) {
+    return {x + shape.minDX, y + shape.minDY, x + shape.maxDX, y + (high ? shape.maxDYHigh : shape.maxDY)};
+}
+
+#endif
@@ -0,0 +1,59 @@
+#include "InputQueue.h"
+#include <algorithm>
+
+void InputQueue::push(InputKey key, bool down, Clock::time_point time) {
+    unsigned t = tail.load(std::memory_order_relaxed);
+    if (t - head.load(std::memory_order_acquire) == CAPACITY) return;
+    pending[t % CAPACITY] = {time, key, down};
+    tail.store(t + 1, std::memory_order_release);
+}
+
+RunnerInput InputQueue::take(Clock::time_point tickTime) {
+    RunnerInput input;
+    bool duckPressed = false;
+    pressApplied = false;
+    unsigned h = head.load(std::memory_order_relaxed);
+    unsigned t = tail.load(std::memory_order_acquire);
+    for (; h != t && pending[h % CAPACITY].time <= tickTime; h++) {
+        const Transition& transition = pending[h % CAPACITY];
+        if (transition.down && !pressApplied) {
+            pressApplied = true;
+            pressTime = transition.time;
+        }
+        if (transition.key == INPUT_JUMP) {
+            input.jump = input.jump || transition.down;
+        } else {
+            duckHeld = transition.down;
+            duckPressed = duckPressed || transition.down;
+        }
+    }
+    head.store(h, std::memory_order_release);
+    input.duck = duckHeld || duckPressed;
+    return input;
+}
+
+void InputQueue::clear() {
+    head.store(tail.load(std::memory_order_acquire), std::memory_order_release);
+    duckHeld = false;
+    pressApplied = false;
+}
+
+void LatencyMeter::add(double ms) {
+    samples[total % SAMPLE_WINDOW] = ms;
+    total++;
+}
+
+PhaseStats LatencyMeter::stats() const {
+    int size = int(std::min(total, (long long)SAMPLE_WINDOW));
+    if (size == 0) return {0, 0, 0};
+
+    double sorted[SAMPLE_WINDOW];
+    std::copy(samples, samples + size, sorted);
+    double sum = 0;
+    for (int i = 0; i < size; i++) {
+        sum += sorted[i];
+    }
+    int p99 = std::min(size - 1, size * 99 / 100);
+    std::nth_element(sorted, sorted + p99, sorted + size);
+    return {*std::min_element(sorted, sorted + size), sum / size, sorted[p99]};
+}
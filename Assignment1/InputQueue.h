@@ -0,0 +1,74 @@
+#ifndef INPUT_QUEUE_H
+#define INPUT_QUEUE_H
+
+#include "RunnerWorld.h"
+#include "Profiler.h"
+#include <atomic>
+#include <chrono>
+
+enum InputKey {
+    INPUT_JUMP,
+    INPUT_DUCK
+};
+
+// Key transitions stamped with when the window system delivered them, turned
+// into one RunnerInput per tick. A transition lands on the first tick due at
+// or after its stamp, so when a frame catches up several ticks each press
+// still hits the tick it belongs to, and a duck tapped between two ticks
+// still ducks for one.
+//
+// push() may run on a different thread from take() and clear(); one thread
+// each, and neither ever waits.
+class InputQueue {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    // Transitions beyond this many pending are dropped
+    static const unsigned CAPACITY = 64; // Power of two
+
+    void push(InputKey key, bool down, Clock::time_point time);
+
+    // Input for the tick due at tickTime; transitions stamped later stay
+    // queued for later ticks.
+    RunnerInput take(Clock::time_point tickTime);
+
+    // Whether the last take() applied a key press, and the stamp of the
+    // earliest one, for measuring latency from there
+    bool pressed() const { return pressApplied; }
+    Clock::time_point firstPress() const { return pressTime; }
+
+    // Drops everything pending; consumer side.
+    void clear();
+
+private:
+    struct Transition {
+        Clock::time_point time;
+        InputKey key;
+        bool down;
+    };
+
+    Transition pending[CAPACITY];
+    alignas(64) std::atomic<unsigned> head{0}; // Next to take; written by the consumer
+    alignas(64) std::atomic<unsigned> tail{0}; // Next to push; written by the producer
+    bool duckHeld = false;
+    bool pressApplied = false;
+    Clock::time_point pressTime;
+};
+
+// Input-to-display latency samples, in milliseconds, with the same
+// statistics as the profiler over the most recent SAMPLE_WINDOW.
+class LatencyMeter {
+public:
+    static const int SAMPLE_WINDOW = 300;
+
+    void add(double ms);
+    PhaseStats stats() const;
+    long long count() const { return total; }
+    void clear() { total = 0; }
+
+private:
+    double samples[SAMPLE_WINDOW];
+    long long total = 0;
+};
+
+#endif
@@ -0,0 +1,228 @@
+#include "LevelConfig.h"
+#include "RunnerWorld.h"
+#include "ByteIO.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+static const char LEVEL_MAGIC[4] = {'R', 'N', 'L', 'V'};
+static const uint8_t LEVEL_VERSION = 1;
+// Keeps a corrupt ramp count from allocating the world
+static const uint32_t MAX_SPEED_RAMPS = 1024;
+
+const LevelConfig& defaultLevel() {
+    static const LevelConfig level;
+    return level;
+}
+
+static bool fail(const char* message) {
+    fprintf(stderr, "Invalid level: %s\n", message);
+    return false;
+}
+
+static bool validChance(const SpawnChance& spawn) {
+    return spawn.outOf > 0 && spawn.chance >= 0 && spawn.chance <= spawn.outOf;
+}
+
+bool LevelConfig::prepare() {
+    if (duration <= 0) return fail("duration must be positive");
+    if (maxHealth <= 0 || maxHealth > MAX_HEALTH_LIMIT) return fail("max_health must be 1 to 20");
+    if (!(jumpVelocity > 0) || !(gravity > 0)) return fail("jump_velocity and gravity must be positive");
+    if (!(initialSpeed >= 0) || !std::isfinite(initialSpeed)) return fail("speed must be zero or more");
+    if (speedRamps.empty() || speedRamps.size() > MAX_SPEED_RAMPS) return fail("need 1 to 1024 speed_ramp lines");
+    for (size_t i = 0; i < speedRamps.size(); i++) {
+        if (speedRamps[i].fromTick < 0 || !std::isfinite(speedRamps[i].perTick)) return fail("bad speed_ramp");
+        if (i > 0 && speedRamps[i].fromTick <= speedRamps[i - 1].fromTick) {
+            return fail("speed_ramp ticks must increase");
+        }
+    }
+    if (!validChance(obstacleSpawn) || !validChance(collectableSpawn) || !validChance(powerupSpawn) ||
+        !validChance(highObstacle) || !validChance(coinMagnet)) {
+        return fail("chances need 0 <= chance <= out_of and out_of > 0");
+    }
+    if (spawnHeightRange <= 0) return fail("spawn_height_range must be positive");
+    if (powerupDuration <= 0) return fail("powerup_duration must be positive");
+    if (!(magnetRadius >= 0) || !std::isfinite(magnetRadius)) return fail("magnet_radius must be zero or more");
+    if (!(magnetKeepPerSecond > 0 && magnetKeepPerSecond <= 1)) return fail("magnet_keep_per_second must be in (0, 1]");
+
+    magnetPullPerTick = float(1 - pow(magnetKeepPerSecond, 1.0 / TICK_RATE));
+    return true;
+}
+
+// Text format: one "key value..." per line, '#' starts a comment.
+static bool parseText(const std::vector<uint8_t>& data, const char* path, LevelConfig& level) {
+    bool rampsGiven = false;
+    std::string text(data.begin(), data.end());
+    size_t start = 0;
+    for (int lineNumber = 1; start < text.size(); lineNumber++) {
+        size_t end = text.find('\n', start);
+        if (end == std::string::npos) end = text.size();
+        std::string line = text.substr(start, end - start);
+        start = end + 1;
+
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+        char key[32];
+        int consumed = 0;
+        if (sscanf(line.c_str(), " %31s%n", key, &consumed) != 1) continue; // Blank
+        const char* args = line.c_str() + consumed;
+
+        int extra = 0;
+        bool ok = true;
+        SpawnChance* chance = nullptr;
+        if (strcmp(key, "duration") == 0) {
+            ok = sscanf(args, "%d %n", &level.duration, &extra) == 1;
+        } else if (strcmp(key, "max_health") == 0) {
+            ok = sscanf(args, "%d %n", &level.maxHealth, &extra) == 1;
+        } else if (strcmp(key, "jump_velocity") == 0) {
+            ok = sscanf(args, "%f %n", &level.jumpVelocity, &extra) == 1;
+        } else if (strcmp(key, "gravity") == 0) {
+            ok = sscanf(args, "%f %n", &level.gravity, &extra) == 1;
+        } else if (strcmp(key, "initial_speed") == 0) {
+            ok = sscanf(args, "%f %n", &level.initialSpeed, &extra) == 1;
+        } else if (strcmp(key, "speed_ramp") == 0) {
+            SpeedRamp ramp;
+            ok = sscanf(args, "%d %f %n", &ramp.fromTick, &ramp.perTick, &extra) == 2;
+            if (ok) {
+                // The first ramp in the file replaces the default ones
+                if (!rampsGiven) level.speedRamps.clear();
+                rampsGiven = true;
+                level.speedRamps.push_back(ramp);
+            }
+        } else if (strcmp(key, "obstacle_spawn") == 0) {
+            chance = &level.obstacleSpawn;
+        } else if (strcmp(key, "collectable_spawn") == 0) {
+            chance = &level.collectableSpawn;
+        } else if (strcmp(key, "powerup_spawn") == 0) {
+            chance = &level.powerupSpawn;
+        } else if (strcmp(key, "high_obstacle") == 0) {
+            chance = &level.highObstacle;
+        } else if (strcmp(key, "coin_magnet") == 0) {
+            chance = &level.coinMagnet;
+        } else if (strcmp(key, "spawn_height_range") == 0) {
+            ok = sscanf(args, "%d %n", &level.spawnHeightRange, &extra) == 1;
+        } else if (strcmp(key, "powerup_duration") == 0) {
+            ok = sscanf(args, "%d %n", &level.powerupDuration, &extra) == 1;
+        } else if (strcmp(key, "magnet_radius") == 0) {
+            ok = sscanf(args, "%f %n", &level.magnetRadius, &extra) == 1;
+        } else if (strcmp(key, "magnet_keep_per_second") == 0) {
+            ok = sscanf(args, "%lf %n", &level.magnetKeepPerSecond, &extra) == 1;
+        } else {
+            fprintf(stderr, "%s:%d: unknown key '%s'\n", path, lineNumber, key);
+            return false;
+        }
+        if (chance) {
+            // "chance out_of", e.g. "2 800"
+            ok = sscanf(args, "%d %d %n", &chance->chance, &chance->outOf, &extra) == 2;
+        }
+        if (!ok || args[extra] != '\0') {
+            fprintf(stderr, "%s:%d: bad value for '%s'\n", path, lineNumber, key);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool parseBinary(const std::vector<uint8_t>& data, LevelConfig& level) {
+    ByteReader reader{data};
+    reader.pos = 4;
+    uint64_t version, duration, maxHealth, rampCount;
+    if (!reader.getUnsigned(version, 1) || version != LEVEL_VERSION) return false;
+    if (!reader.getUnsigned(duration, 4) || !reader.getUnsigned(maxHealth, 4)) return false;
+    level.duration = int(uint32_t(duration));
+    level.maxHealth = int(uint32_t(maxHealth));
+    if (!reader.getFloat(level.jumpVelocity) || !reader.getFloat(level.gravity) ||
+        !reader.getFloat(level.initialSpeed)) {
+        return false;
+    }
+    if (!reader.getUnsigned(rampCount, 4) || rampCount > MAX_SPEED_RAMPS) return false;
+    level.speedRamps.resize(rampCount);
+    for (SpeedRamp& ramp : level.speedRamps) {
+        uint64_t fromTick;
+        if (!reader.getUnsigned(fromTick, 4) || !reader.getFloat(ramp.perTick)) return false;
+        ramp.fromTick = int(uint32_t(fromTick));
+    }
+    SpawnChance* chances[] = {&level.obstacleSpawn, &level.collectableSpawn, &level.powerupSpawn,
+                              &level.highObstacle, &level.coinMagnet};
+    for (SpawnChance* chance : chances) {
+        uint64_t value, outOf;
+        if (!reader.getUnsigned(value, 4) || !reader.getUnsigned(outOf, 4)) return false;
+        chance->chance = int(uint32_t(value));
+        chance->outOf = int(uint32_t(outOf));
+    }
+    uint64_t spawnHeightRange, powerupDuration;
+    if (!reader.getUnsigned(spawnHeightRange, 4) || !reader.getUnsigned(powerupDuration, 4)) return false;
+    level.spawnHeightRange = int(uint32_t(spawnHeightRange));
+    level.powerupDuration = int(uint32_t(powerupDuration));
+    if (!reader.getFloat(level.magnetRadius) || !reader.getDouble(level.magnetKeepPerSecond)) return false;
+    return reader.pos == data.size();
+}
+
+bool LevelConfig::load(const char* path) {
+    std::vector<uint8_t> data;
+    if (!readFile(path, data)) {
+        fprintf(stderr, "Could not read level %s\n", path);
+        return false;
+    }
+
+    LevelConfig level;
+    bool binary = data.size() >= 4 && std::equal(LEVEL_MAGIC, LEVEL_MAGIC + 4, data.begin());
+    if (binary) {
+        if (!parseBinary(data, level)) {
+            fprintf(stderr, "%s: truncated or unsupported binary level\n", path);
+            return false;
+        }
+    } else if (!parseText(data, path, level)) {
+        return false;
+    }
+    if (!level.prepare()) {
+        fprintf(stderr, "(in %s)\n", path);
+        return false;
+    }
+    *this = level;
+    return true;
+}
+
+static void encode(const LevelConfig& level, std::vector<uint8_t>& out) {
+    out.assign(LEVEL_MAGIC, LEVEL_MAGIC + 4);
+    out.push_back(LEVEL_VERSION);
+    putUnsigned(out, uint32_t(level.duration), 4);
+    putUnsigned(out, uint32_t(level.maxHealth), 4);
+    putFloat(out, level.jumpVelocity);
+    putFloat(out, level.gravity);
+    putFloat(out, level.initialSpeed);
+    putUnsigned(out, uint32_t(level.speedRamps.size()), 4);
+    for (const SpeedRamp& ramp : level.speedRamps) {
+        putUnsigned(out, uint32_t(ramp.fromTick), 4);
+        putFloat(out, ramp.perTick);
+    }
+    const SpawnChance* chances[] = {&level.obstacleSpawn, &level.collectableSpawn, &level.powerupSpawn,
+                                    &level.highObstacle, &level.coinMagnet};
+    for (const SpawnChance* chance : chances) {
+        putUnsigned(out, uint32_t(chance->chance), 4);
+        putUnsigned(out, uint32_t(chance->outOf), 4);
+    }
+    putUnsigned(out, uint32_t(level.spawnHeightRange), 4);
+    putUnsigned(out, uint32_t(level.powerupDuration), 4);
+    putFloat(out, level.magnetRadius);
+    putDouble(out, level.magnetKeepPerSecond);
+}
+
+bool LevelConfig::save(const char* path) const {
+    std::vector<uint8_t> out;
+    encode(*this, out);
+    return writeFile(path, out);
+}
+
+uint64_t LevelConfig::hash() const {
+    std::vector<uint8_t> bytes;
+    encode(*this, bytes);
+    uint64_t hash = 14695981039346656037ULL;
+    for (uint8_t byte : bytes) {
+        hash = (hash ^ byte) * 1099511628211ULL;
+    }
+    return hash;
+}
@@ -0,0 +1,120 @@
+#ifndef LEVEL_CONFIG_H
+#define LEVEL_CONFIG_H
+
+#include "Rng.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Simulation steps per second that every per-tick setting below is tuned
+// for. A game run at another --tick-rate plays faster or slower as a whole.
+const int TICK_RATE = 60;
+
+// Default tuning, used when no level file is given
+const float INITIAL_GAME_SPEED = 2.0f;
+const float GAME_SPEED_INCREASE = 0.001f; // Per tick
+const int GAME_DURATION = 6000; // 60 seconds
+const int MAX_HEALTH = 5;
+const float JUMP_VELOCITY = 13.0f;
+const float GRAVITY = 0.5f;
+const int POWERUP_DURATION = 500; // 5 seconds
+const int SPAWN_HEIGHT_RANGE = 100; // Collectables and powerups spawn this far above the ground at most
+
+// Coin magnet: collectables ahead of the player and within MAGNET_RADIUS are
+// left with this fraction of their distance to the player after a second of
+// pull at TICK_RATE (0.9 per tick).
+const float MAGNET_RADIUS = 250;
+const double MAGNET_KEEP_PER_SECOND = 0.0017970102999144; // 0.9^60
+
+// Hearts are drawn along the top boundary, which has room for this many
+const int MAX_HEALTH_LIMIT = 20;
+
+// chance in outOf, rolled with one rng.below(outOf)
+struct SpawnChance {
+    int chance;
+    int outOf;
+
+    bool roll(Rng& rng) const { return rng.below(outOf) < chance; }
+};
+
+// From fromTick on (until the next ramp), the game speeds up by perTick
+// every tick.
+struct SpeedRamp {
+    int fromTick;
+    float perTick;
+};
+
+// Everything a level can tune. Loaded from a text or binary level file (see
+// levels/default.txt for the text format), validated, and turned into the
+// derived fields below once, so stepping a world never parses or recomputes
+// anything. Worlds point at a level; many worlds can share one.
+//
+// Binary layout (little-endian):
+//   "RNLV"  magic
+//   u8      version (1)
+//   u32     duration, max health
+//   f32     jump velocity, gravity, initial speed
+//   u32     speed ramp count, then per ramp: u32 from tick, f32 per tick
+//   u32     chance, out of: obstacle, collectable, powerup spawns;
+//           high obstacle, coin magnet variants
+//   u32     spawn height range, powerup duration
+//   f32     magnet radius
+//   f64     magnet keep per second
+struct LevelConfig {
+    int duration = GAME_DURATION;
+    int maxHealth = MAX_HEALTH;
+
+    float jumpVelocity = JUMP_VELOCITY;
+    float gravity = GRAVITY;
+
+    float initialSpeed = INITIAL_GAME_SPEED;
+    std::vector<SpeedRamp> speedRamps = {{0, GAME_SPEED_INCREASE}};
+
+    // Rolled once per tick each
+    SpawnChance obstacleSpawn = {2, 800};
+    SpawnChance collectableSpawn = {3, 200};
+    SpawnChance powerupSpawn = {5, 1200};
+    // Rolled per spawn: tall obstacle instead of low, magnet instead of
+    // double points
+    SpawnChance highObstacle = {1, 2};
+    SpawnChance coinMagnet = {1, 2};
+    int spawnHeightRange = SPAWN_HEIGHT_RANGE;
+
+    int powerupDuration = POWERUP_DURATION;
+    float magnetRadius = MAGNET_RADIUS;
+    double magnetKeepPerSecond = MAGNET_KEEP_PER_SECOND;
+
+    // Derived by prepare()
+    float magnetPullPerTick = 0;
+
+    LevelConfig() { prepare(); }
+
+    // Reads a text or binary level file (told apart by the binary magic).
+    // Reports problems on stderr, with line numbers for text files, and
+    // leaves the config unchanged on failure.
+    bool load(const char* path);
+    bool save(const char* path) const; // Binary
+    // FNV-1a of the binary form: equal for levels that play identically,
+    // however they were written. Replays store it.
+    uint64_t hash() const;
+
+    // Checks every field and rebuilds the derived ones; false (with a message
+    // on stderr) if the level is unplayable.
+    bool prepare();
+
+    // The active ramp's increment; ticks before the first ramp keep the
+    // initial speed, and ticks past the run's end keep its last increment.
+    // A binary search over the ramps, so memory does not grow with duration.
+    float speedIncreaseAt(long long tick) const {
+        if (tick >= duration) tick = duration - 1;
+        auto after = std::upper_bound(speedRamps.begin(), speedRamps.end(), tick,
+                                      [](long long t, const SpeedRamp& ramp) { return t < ramp.fromTick; });
+        return after == speedRamps.begin() ? 0.0f : (after - 1)->perTick;
+    }
+};
+
+// The built-in level, equal to a LevelConfig left at its defaults
+const LevelConfig& defaultLevel();
+
+#endif
@@ -1,108 +1,249 @@
-#define GL_SILENCE_DEPRECATION
-#include <GLUT/glut.h>
+#include "GLIncludes.h"
+#include "Audio.h"
+#include "RunnerWorld.h"
+#include "RunnerScene.h"
+#include "BatchRenderer.h"
+#include "CoreProfile.h"
+#include "FixedStep.h"
+#include "FrameReadback.h"
+#include "InputQueue.h"
+#include "Replay.h"
+#include "Profiler.h"
+#include "TextRenderer.h"
+#include "TripleBuffer.h"
+#include "VideoWriter.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <ctime>
 #include <cstdlib>
-#include <string>
 #include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
 
-// Game constants
-const int WINDOW_WIDTH = 800;
-const int WINDOW_HEIGHT = 600;
-const int PLAYER_WIDTH = 30;
-const int PLAYER_HEIGHT = 50;
-const int PLAYER_DUCK_HEIGHT = 25;
-const int OBSTACLE_WIDTH = 30;
-const int OBSTACLE_HEIGHT = 55;
-const int COLLECTABLE_SIZE = 20;
-const int POWERUP_SIZE = 25;
-const float INITIAL_GAME_SPEED = 2.0f;
-const int GAME_DURATION = 6000; // 60 seconds
-const int GROUND_HEIGHT = 50;
-const int BOUNDARY_HEIGHT = 30;
-const int MAX_HEALTH = 5;
-const float JUMP_VELOCITY = 13.0f;
-const float GRAVITY = 0.5f;
-const int POWERUP_DURATION = 500; // 5 seconds
-
-// Game variables
-float playerX = 100;
-float playerY = GROUND_HEIGHT;
-bool isJumping = false;
-bool isDucking = false;
-float jumpVelocity = 0;
-int score = 0;
-int health = MAX_HEALTH;
-int gameTime = GAME_DURATION;
-float gameSpeed = INITIAL_GAME_SPEED;
-bool gameOver = false;
-bool coinMagnet = false;
-int coinMagnetTime = 0;
-bool doublePoints = false;
-int doublePointsTime = 0;
-
-// Game objects
-struct GameObject {
-    float x, y;
-    bool active;
-    float animationOffset;
-    bool isHighObstacle;
+// The simulation itself lives in RunnerWorld; this file is the GLUT front end
+RunnerWorld world;
+
+// Everything display() needs from the simulation, published after every
+// batch of ticks. display() only ever draws the newest snapshot, so the
+// world can be stepped on another thread (--sim-thread) without the two
+// sharing any state.
+struct FrameSnapshot {
+    SceneState scene;
+    float backgroundScroll = 0;
+    float backgroundScrollPrev = 0;
+    std::chrono::steady_clock::time_point tickTime; // When the newest tick fell due, for blending
+    int run = 0;                                     // Bumped by every startGame()
+    long long presses = 0;                           // Key presses applied this run
+    InputQueue::Clock::time_point lastPress;
+    PhaseStats simStats[PHASE_DRAW];                 // Simulation phases, with --sim-thread
 };
-
-std::vector<GameObject> obstacles;
-std::vector<GameObject> collectables;
-std::vector<GameObject> powerups;
+TripleBuffer<FrameSnapshot> snapshots;
+const FrameSnapshot* frame = nullptr; // The snapshot being drawn
+
+// With --sim-thread the world, clock, input and replay below belong to the
+// simulation thread; the GLUT thread only posts input and restart requests
+bool simThreadMode = false;
+std::thread simThread;
+std::atomic<bool> simRunning{false};
+std::atomic<bool> restartRequested{false};
+std::mutex simWakeMutex;
+std::condition_variable simWake; // The simulation thread sleeps on this while idle
+int run = 0;
+long long presses = 0;
+InputQueue::Clock::time_point lastPress;
+
+// Shapes are built once; each frame instances them into one batch
+SceneMeshes sceneMeshes;
+DrawBatch sceneBatch;
+BatchRenderer batchRenderer;
+StaticBatch groundLayer;
+StaticBatch skyLayer;
+DrawBatch restartButton;
+
+// --core-profile draws through GL 3.3 core shaders, with coins, cactus tops,
+// glows and hearts as anti-aliased distance-field quads
+bool coreProfile = false;
+
+// Text is drawn from a glyph atlas baked at startup. Labels keep
+// their quads until the number they show changes.
+TextRenderer textRenderer;
+std::vector<TextVertex> hudText;
+TextLabel scoreLabel(FONT_LARGE, WINDOW_WIDTH - 100, WINDOW_HEIGHT - BOUNDARY_HEIGHT/2, 1.0f, 1.0f, 1.0f, "Score: ");
+TextLabel timeLabel(FONT_LARGE, WINDOW_WIDTH / 2 - 30, WINDOW_HEIGHT - BOUNDARY_HEIGHT/2, 1.0f, 1.0f, 1.0f, "Time: ");
+TextLabel coinMagnetLabel(FONT_SMALL, 10, WINDOW_HEIGHT - BOUNDARY_HEIGHT - 20, 0.0f, 1.0f, 1.0f, "Coin Magnet: ");
+TextLabel doublePointsLabel(FONT_SMALL, 10, WINDOW_HEIGHT - BOUNDARY_HEIGHT - 40, 1.0f, 1.0f, 0.0f, "Double Points: ");
+TextLabel gameEndLabel(FONT_LARGE, WINDOW_WIDTH / 2 - 50, WINDOW_HEIGHT / 2, 1.0f, 1.0f, 1.0f, "GAME END");
+TextLabel gameLostLabel(FONT_LARGE, WINDOW_WIDTH / 2 - 50, WINDOW_HEIGHT / 2, 1.0f, 1.0f, 1.0f, "GAME LOST");
+TextLabel gameOverLabel(FONT_LARGE, WINDOW_WIDTH / 2 - 50, WINDOW_HEIGHT / 2, 1.0f, 1.0f, 1.0f, "GAME OVER");
+TextLabel finalScoreLabel(FONT_LARGE, WINDOW_WIDTH / 2 - 70, WINDOW_HEIGHT / 2 - 30, 1.0f, 1.0f, 1.0f, "Final Score: ");
+TextLabel restartLabel(FONT_LARGE, WINDOW_WIDTH / 2 - 30, WINDOW_HEIGHT / 2 - 70, 0.0f, 0.0f, 0.0f, "Restart");
+
+// Nothing animates while paused or on the game-over screen, so the timer
+// stops rearming and frames are only drawn for input, reshape and expose.
+// P pauses and resumes; hiding the window pauses. With --sim-thread the
+// simulation thread sleeps too.
+std::atomic<bool> paused{false};
+bool timerArmed = false;
+bool restartPending = false; // Requested, but no snapshot from the new run yet
+int restartFromRun = 0;
+TextLabel pausedLabel(FONT_LARGE, WINDOW_WIDTH / 2 - 40, WINDOW_HEIGHT / 2, 1.0f, 1.0f, 1.0f, "PAUSED");
+TextLabel resumeLabel(FONT_SMALL, WINDOW_WIDTH / 2 - 55, WINDOW_HEIGHT / 2 - 25, 1.0f, 1.0f, 1.0f, "Press P to resume");
+
+// Distance the background has scrolled, wrapped so both layers stay periodic
+bool parallax = false;
+float backgroundScroll = 0;
+float backgroundScrollPrev = 0;
+
+// Simulation runs at tickRate regardless of how often frames are drawn
+int renderRate = 60;
+int tickRate = TICK_RATE;
+FixedStepClock stepClock(TICK_RATE);
+bool simIdle = false; // Last simulate() found the game paused or over; only simulate() touches it
+
+// Key transitions are queued with their arrival time and applied at the
+// tick they fall in, which is what makes runs replayable
+InputQueue inputQueue;
+bool fixedSeed = false;
+uint64_t seedOption = 0;
+const char* recordPath = nullptr;
+const char* replayPath = nullptr;
+Replay replay;
+LevelConfig level; // Built-in defaults unless --level is given
+
+// F3 toggles the timing overlay; --profile-csv dumps every frame at game over.
+// With --sim-thread the simulation times itself in simProfiler, and its CSV
+// rows are simulation loop iterations rather than frames.
+Profiler profiler;
+Profiler simProfiler;
+int simStatsAge = 0;
+int drawnRun = -1;
+bool showProfiler = false;
+const char* profileCsvPath = nullptr;
+std::vector<TextVertex> overlayText;
+int overlayAge = 0;
+
+// --latency times each key press to the end of the first buffer swap that
+// shows its effect
+bool measureLatency = false;
+LatencyMeter latency;
+long long measuredPresses = 0;
+bool latencyReported = false;
+
+// --capture records every drawn frame: pixels come back through pixel buffer
+// objects a couple of frames late and a writer thread encodes them
+const char* capturePath = nullptr;
+VideoWriter video;
+FrameReadback readback;
+
+// Sound effects, mixed on their own thread; --mute plays them into the null
+// backend instead
+AudioEngine audio;
+bool mute = false;
 
 // Function prototypes
 void display();
 void reshape(int w, int h);
 void timer(int);
+void visibility(int state);
 void keyboard(unsigned char key, int x, int y);
 void keyboardUp(unsigned char key, int x, int y);
-void drawPlayer();
-void drawObstacle(float x, float y, bool isHigh);
-void drawCollectable(float x, float y, float offset);
-void drawPowerup(float x, float y, float offset, bool isCoinMagnet);
-void drawGround();
-void drawBoundaries();
+void specialKey(int key, int x, int y);
+void drawBackground(float alpha);
 void drawHUD();
-void updateGame();
-void spawnObjects();
-void restartGame();
+void drawProfilerOverlay();
 void drawGameOver();
 void mouseClick(int button, int state, int x, int y);
+void startGame();
+void requestRestart();
+void setPaused(bool pause);
+void wake();
+void finishGame();
+void playWorldSounds();
+void simulate();
+void publishFrame(std::chrono::steady_clock::time_point tickTime);
 
 
 void display() {
+    frame = &snapshots.read();
+    if (frame->run != drawnRun) {
+        drawnRun = frame->run;
+        if (simThreadMode) {
+            profiler.clear();
+        }
+        latency.clear();
+        measuredPresses = frame->presses;
+        latencyReported = false;
+    }
+
     glClear(GL_COLOR_BUFFER_BIT);
-    glLoadIdentity();
+    if (!coreProfile) {
+        glLoadIdentity();
+    }
 
-    if (gameOver) {
+    if (frame->scene.gameOver) {
         drawGameOver();
     } else {
-        drawGround();
-        drawBoundaries();
-        drawPlayer();
+        ScopedTimer drawTimer(&profiler, PHASE_DRAW);
+        // Blend from the previous tick by how long ago the newest fell due
+        double sinceTick = std::chrono::duration<double>(std::chrono::steady_clock::now() - frame->tickTime).count();
+        float alpha = float(std::max(0.0, std::min(sinceTick * tickRate, 1.0)));
+        drawBackground(alpha);
 
-        for (const auto& obj : obstacles) {
-            if (obj.active) drawObstacle(obj.x, obj.y, obj.isHighObstacle);
-        }
-
-        for (const auto& obj : collectables) {
-            if (obj.active) drawCollectable(obj.x, obj.y, obj.animationOffset);
-        }
-
-        for (const auto& obj : powerups) {
-            if (obj.active) drawPowerup(obj.x, obj.y, obj.animationOffset, obj.isHighObstacle);
-        }
+        sceneBatch.clear();
+        emitScene(frame->scene, sceneMeshes, sceneBatch, alpha);
+        batchRenderer.draw(sceneBatch);
 
         drawHUD();
     }
+    if (showProfiler) {
+        drawProfilerOverlay();
+    }
+    readback.capture();
 
-    glutSwapBuffers();
+    {
+        ScopedTimer swapTimer(&profiler, PHASE_SWAP);
+        glutSwapBuffers();
+    }
+    if (measureLatency && frame->presses > measuredPresses) {
+        // Blocks until the swap has gone through, which is as close to the
+        // press reaching the screen as GL can tell
+        glFinish();
+        auto shown = InputQueue::Clock::now();
+        latency.add(std::chrono::duration<double, std::milli>(shown - frame->lastPress).count());
+        measuredPresses = frame->presses;
+    }
+    if (!frame->scene.gameOver && !paused) {
+        profiler.endFrame();
+    } else if (measureLatency && !latencyReported && latency.count() > 0) {
+        PhaseStats stats = latency.stats();
+        printf("Input latency over %lld presses: min %.2f  avg %.2f  p99 %.2f ms\n", latency.count(),
+               stats.minMs, stats.avgMs, stats.p99Ms);
+        latencyReported = true;
+    }
 }
 
 void reshape(int w, int h) {
+    if (readback.started()) {
+        // The capture is a fixed size, so the window is held to it while
+        // recording; frames drawn before the window manager complies are
+        // dropped
+        readback.setWindowSize(w, h);
+        if (w != video.width() || h != video.height()) {
+            glutReshapeWindow(video.width(), video.height());
+        }
+    }
+    if (coreProfile) {
+        setCoreView(WINDOW_WIDTH, WINDOW_HEIGHT, w, h);
+        // Wide lines are expanded for the pixel size at upload
+        groundLayer.upload(sceneMeshes.ground);
+        skyLayer.upload(sceneMeshes.sky);
+        return;
+    }
     glViewport(0, 0, w, h);
     glMatrixMode(GL_PROJECTION);
     glLoadIdentity();
@@ -111,679 +252,499 @@ void reshape(int w, int h) {
 }
 
 void timer(int) {
-    if (!gameOver) {
-        updateGame();
+    if (!simThreadMode) {
+        simulate();
+    }
+    frame = &snapshots.read();
+    if (restartPending && frame->run != restartFromRun) {
+        restartPending = false;
     }
     glutPostRedisplay();
-    glutTimerFunc(1000 / 60, timer, 0);
+    if (paused || (frame->scene.gameOver && !restartPending)) {
+        // This frame shows the still screen; nothing more until wake()
+        timerArmed = false;
+        audio.setIdle(true);
+        readback.flush();
+        return;
+    }
+    glutTimerFunc(1000 / renderRate, timer, 0);
 }
 
-void keyboard(unsigned char key, int x, int y) {
-    if (key == ' ' && !isJumping && playerY == GROUND_HEIGHT) {
-        isJumping = true;
-        jumpVelocity = JUMP_VELOCITY;
-    }
-    if (key == 'd' || key == 'D') {
-        isDucking = true;
-    }
-    if (key == 'r' || key == 'R') {
-        if (gameOver) {
-            restartGame();
+// Restarts the frame timer (and with it the simulation) if it has stopped.
+void wake() {
+    audio.setIdle(false);
+    if (simThreadMode) {
+        {
+            std::lock_guard<std::mutex> lock(simWakeMutex);
         }
+        simWake.notify_one();
+    }
+    if (!timerArmed) {
+        timerArmed = true;
+        glutTimerFunc(0, timer, 0);
     }
 }
 
-void keyboardUp(unsigned char key, int x, int y) {
-    if (key == 'd' || key == 'D') {
-        isDucking = false;
+void setPaused(bool pause) {
+    if (pause == paused || (frame && frame->scene.gameOver)) return;
+    paused = pause;
+    if (pause) {
+        glutPostRedisplay();
+    } else {
+        wake();
     }
 }
 
-void drawPlayer() {
-    glPushMatrix();
-    glTranslatef(playerX, playerY, 0);
-
-    float height = isDucking ? PLAYER_DUCK_HEIGHT : PLAYER_HEIGHT;
-
-    // Body (Quad)
-    glColor3f(0.0f, 0.0f, 1.0f);
-    glBegin(GL_QUADS);
-    glVertex2f(-PLAYER_WIDTH/2, 0);
-    glVertex2f(PLAYER_WIDTH/2, 0);
-    glVertex2f(PLAYER_WIDTH/2, height);
-    glVertex2f(-PLAYER_WIDTH/2, height);
-    glEnd();
-
-    // Head (Triangle)
-    glColor3f(1.0f, 0.8f, 0.6f);
-    glBegin(GL_TRIANGLES);
-    glVertex2f(-PLAYER_WIDTH/4, height);
-    glVertex2f(PLAYER_WIDTH/4, height);
-    glVertex2f(0, height + PLAYER_WIDTH/2);
-    glEnd();
-
-    // Eye (Point)
-    glColor3f(0.0f, 0.0f, 0.0f);
-    glPointSize(3.0f);
-    glBegin(GL_POINTS);
-    glVertex2f(PLAYER_WIDTH/8, height + PLAYER_WIDTH/4);
-    glEnd();
-
-    // Arm (Line)
-    glColor3f(0.0f, 0.0f, 0.8f);
-    glBegin(GL_LINES);
-    glVertex2f(PLAYER_WIDTH/2, height*3/4);
-    glVertex2f(PLAYER_WIDTH, height/2);
-    glEnd();
-
-    glPopMatrix();
+void requestRestart() {
+    restartFromRun = frame ? frame->run : run;
+    restartPending = true;
+    paused = false;
+    restartRequested = true;
+    wake();
 }
 
-void drawObstacle(float x, float y, bool isHigh) {
-    glPushMatrix();
-        glTranslatef(x, y, 0);
-
-        float height = isHigh ? OBSTACLE_HEIGHT * 3.0f : 70;
-        float width = OBSTACLE_WIDTH;
-
-        // Main body (Rectangle)
-        glColor3f(0.0f, 0.5f, 0.0f);  // Dark green
-        glBegin(GL_QUADS);
-        glVertex2f(-width/4, 0);
-        glVertex2f(width/4, 0);
-        glVertex2f(width/4, height);
-        glVertex2f(-width/4, height);
-        glEnd();
-
-        // Left arm (Triangle)
-        glBegin(GL_TRIANGLES);
-        glVertex2f(-width/4, height * 0.6f);
-        glVertex2f(-width/2, height * 0.8f);
-        glVertex2f(-width/4, height * 0.9f);
-        glEnd();
-
-        // Right arm (Triangle)
-        glBegin(GL_TRIANGLES);
-        glVertex2f(width/4, height * 0.5f);
-        glVertex2f(width/2, height * 0.7f);
-        glVertex2f(width/4, height * 0.8f);
-        glEnd();
-
-        // Spikes (Lines)
-        glColor3f(1.0f, 1.0f, 1.0f);  // White
-        glBegin(GL_LINES);
-        for (float i = 0.1f; i < 1.0f; i += 0.2f) {
-            // Left side spikes
-            glVertex2f(-width/4, height * i);
-            glVertex2f(-width/3, height * (i + 0.05f));
-
-            // Right side spikes
-            glVertex2f(width/4, height * (i + 0.05f));
-            glVertex2f(width/3, height * (i + 0.1f));
-        }
-        glEnd();
-
-        // Top (small circle)
-        glColor3f(1.0f, 0.5f, 0.8f);  // Pink
-        glBegin(GL_TRIANGLE_FAN);
-        for (int i = 0; i <= 360; i += 10) {
-            float radian = i * 3.14159f / 180.0f;
-            glVertex2f(cos(radian) * width/8 + 0, sin(radian) * width/8 + height);
-        }
-        glEnd();
-
-        glPopMatrix();
+void visibility(int state) {
+    if (state == GLUT_NOT_VISIBLE) {
+        setPaused(true);
+    }
 }
 
-void drawCollectable(float x, float y, float offset) {
-    glPushMatrix();
-        glTranslatef(x, y + COLLECTABLE_SIZE/2 , 0);
-
-        // Outer circle (Polygon)
-        glColor3f(1.0f, 1.0f, 0.0f);
-        glBegin(GL_POLYGON);
-        for (int i = 0; i < 16; i++) {
-            float angle = 2.0f * M_PI * float(i) / 16;
-            glVertex2f(cos(angle) * COLLECTABLE_SIZE/2, sin(angle) * COLLECTABLE_SIZE/2);
+// Runs the ticks owed since the last call and publishes the result. Called
+// from timer(), or in a loop on the simulation thread with --sim-thread.
+void simulate() {
+    if (restartRequested.exchange(false)) {
+        startGame();
+    }
+    if (paused || world.gameOver) {
+        simIdle = true;
+        return;
+    }
+    if (simIdle) {
+        // First call after a pause or game over. Time spent idle is not owed
+        // as ticks, and keys pressed meanwhile must not act now; this is the
+        // thread that takes from the queue, so clearing it here cannot race
+        // a take()
+        simIdle = false;
+        stepClock.reset();
+        inputQueue.clear();
+    }
+
+    int steps = stepClock.advance();
+    int stepped = 0;
+    for (int i = 0; i < steps && !world.gameOver; i++, stepped++) {
+        RunnerInput live = inputQueue.take(stepClock.tickTime(i));
+        if (inputQueue.pressed()) {
+            presses++;
+            lastPress = inputQueue.firstPress();
         }
-        glEnd();
-
-        // Inner star (Triangles)
-        glColor3f(1.0f, 0.8f, 0.0f);
-        glBegin(GL_TRIANGLES);
-        for (int i = 0; i < 5; i++) {
-            float angle1 = 2.0f * M_PI * float(i) / 5;
-            float angle2 = 2.0f * M_PI * float(i + 1) / 5;
-            glVertex2f(0, 0);
-            glVertex2f(cos(angle1) * COLLECTABLE_SIZE/3, sin(angle1) * COLLECTABLE_SIZE/3);
-            glVertex2f(cos(angle2) * COLLECTABLE_SIZE/3, sin(angle2) * COLLECTABLE_SIZE/3);
+        RunnerInput input = replayPath ? replay.at(world.tick) : live;
+        if (recordPath) {
+            replay.record(input);
         }
-        glEnd();
-
-        // Decorative lines (Line Strip)
-        glColor3f(1.0f, 0.5f, 0.0f);
-        glBegin(GL_LINE_STRIP);
-        for (int i = 0; i <= 5; i++) {
-            float angle = 2.0f * M_PI * float(i) / 5;
-            float innerRadius = COLLECTABLE_SIZE/6;
-            float outerRadius = COLLECTABLE_SIZE/3;
-            glVertex2f(cos(angle) * innerRadius, sin(angle) * innerRadius);
-            glVertex2f(cos(angle) * outerRadius, sin(angle) * outerRadius);
+        world.applyInput(input);
+        world.step();
+        playWorldSounds();
+
+        backgroundScrollPrev = backgroundScroll;
+        backgroundScroll += world.gameSpeed;
+        if (backgroundScroll >= 2 * BACKGROUND_PERIOD) {
+            backgroundScroll -= 2 * BACKGROUND_PERIOD;
+            backgroundScrollPrev -= 2 * BACKGROUND_PERIOD;
         }
-        glEnd();
-
-        // Center (Point)
-        glColor3f(1.0f, 0.5f, 0.0f);
-        glPointSize(3.0f);
-        glBegin(GL_POINTS);
-        glVertex2f(0, 0);
-        glEnd();
 
-        glPopMatrix();
+        if (world.gameOver) {
+            finishGame();
+        }
+    }
+    if (stepped > 0) {
+        if (simThreadMode) {
+            simProfiler.endFrame();
+        }
+        publishFrame(stepClock.tickTime(stepped - 1));
+    }
 }
 
-const int CIRCLE_SEGMENTS = 20;
-
-void drawPowerup(float x, float y, float offset, bool isCoinMagnet) {
-    glPushMatrix();
-        glTranslatef(x, y + offset, 0);
-
-        if (isCoinMagnet) {
-            // Coin Magnet (Horseshoe Magnet)
-
-            // Horseshoe shape
-            glBegin(GL_TRIANGLE_STRIP);
-            for (int i = 0; i <= CIRCLE_SEGMENTS; i++) {
-                float angle = i * M_PI / CIRCLE_SEGMENTS;
-                float c = cos(angle);
-                float s = sin(angle);
-
-                // Outer edge (red)
-                glColor3f(0.8f - 0.2f * s, 0.2f, 0.2f);
-                glVertex2f(c * POWERUP_SIZE, s * POWERUP_SIZE);
-
-                // Inner edge (lighter red)
-                glColor3f(1.0f - 0.2f * s, 0.4f, 0.4f);
-                glVertex2f(c * POWERUP_SIZE * 0.7f, s * POWERUP_SIZE * 0.7f);
-            }
-            glEnd();
-
-            // Magnet poles (bright red)
-            glColor3f(1.0f, 0.2f, 0.2f);
-            glBegin(GL_QUADS);
-            // Left pole
-            glVertex2f(-POWERUP_SIZE, 0);
-            glVertex2f(-POWERUP_SIZE * 0.7f, 0);
-            glVertex2f(-POWERUP_SIZE * 0.7f, -POWERUP_SIZE * 0.4f);
-            glVertex2f(-POWERUP_SIZE, -POWERUP_SIZE * 0.4f);
-            // Right pole
-            glVertex2f(POWERUP_SIZE * 0.7f, 0);
-            glVertex2f(POWERUP_SIZE, 0);
-            glVertex2f(POWERUP_SIZE, -POWERUP_SIZE * 0.4f);
-            glVertex2f(POWERUP_SIZE * 0.7f, -POWERUP_SIZE * 0.4f);
-            glEnd();
-
-            // Magnetic field lines
-            glColor4f(0.9f, 0.4f, 0.4f, 0.7f);
-            glEnable(GL_BLEND);
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-            glBegin(GL_LINES);
-            for (int i = 0; i < 5; i++) {
-                float y = -POWERUP_SIZE * 0.5f - i * 0.1f * POWERUP_SIZE;
-                glVertex2f(-POWERUP_SIZE, y);
-                glVertex2f(0, y - POWERUP_SIZE * 0.2f);
-                glVertex2f(0, y - POWERUP_SIZE * 0.2f);
-                glVertex2f(POWERUP_SIZE, y);
-            }
-            glEnd();
-            glDisable(GL_BLEND);
-
-            // Metallic shine
-            glColor4f(1.0f, 1.0f, 1.0f, 0.5f);
-            glEnable(GL_BLEND);
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-            glBegin(GL_TRIANGLE_STRIP);
-            for (int i = 0; i <= CIRCLE_SEGMENTS / 2; i++) {
-                float angle = i * M_PI / CIRCLE_SEGMENTS;
-                float c = cos(angle);
-                float s = sin(angle);
-                glVertex2f(c * POWERUP_SIZE * 0.9f, s * POWERUP_SIZE * 0.9f);
-                glVertex2f(c * POWERUP_SIZE * 0.8f, s * POWERUP_SIZE * 0.8f);
-            }
-            glEnd();
-            glDisable(GL_BLEND);
-
-        } else {
-            // Double Points Powerup (Diamond with 2x)
-
-            // Diamond shape
-            glColor3f(0.0f, 0.7f, 1.0f);  // Cyan color
-            glBegin(GL_TRIANGLE_FAN);
-            glVertex2f(0, POWERUP_SIZE);  // Top
-            glVertex2f(POWERUP_SIZE, 0);  // Right
-            glVertex2f(0, -POWERUP_SIZE); // Bottom
-            glVertex2f(-POWERUP_SIZE, 0); // Left
-            glVertex2f(0, POWERUP_SIZE);  // Back to top
-            glEnd();
-
-            // Inner diamond (for depth effect)
-            glColor3f(0.0f, 0.9f, 1.0f);  // Lighter cyan
-            glBegin(GL_TRIANGLE_FAN);
-            glVertex2f(0, POWERUP_SIZE * 0.8f);
-            glVertex2f(POWERUP_SIZE * 0.8f, 0);
-            glVertex2f(0, -POWERUP_SIZE * 0.8f);
-            glVertex2f(-POWERUP_SIZE * 0.8f, 0);
-            glVertex2f(0, POWERUP_SIZE * 0.8f);
-            glEnd();
-
-            // "2x" symbol
-            glColor3f(1.0f, 1.0f, 1.0f);  // White color
-            glLineWidth(2.0f);
-            glBegin(GL_LINES);
-            // '2'
-            glVertex2f(-POWERUP_SIZE/4, POWERUP_SIZE/4);
-            glVertex2f(0, POWERUP_SIZE/4);
-            glVertex2f(0, POWERUP_SIZE/4);
-            glVertex2f(0, 0);
-            glVertex2f(0, 0);
-            glVertex2f(-POWERUP_SIZE/4, 0);
-            glVertex2f(-POWERUP_SIZE/4, 0);
-            glVertex2f(-POWERUP_SIZE/4, -POWERUP_SIZE/4);
-            glVertex2f(-POWERUP_SIZE/4, -POWERUP_SIZE/4);
-            glVertex2f(0, -POWERUP_SIZE/4);
-            // 'x'
-            glVertex2f(POWERUP_SIZE/8, POWERUP_SIZE/4);
-            glVertex2f(POWERUP_SIZE/3, -POWERUP_SIZE/4);
-            glVertex2f(POWERUP_SIZE/8, -POWERUP_SIZE/4);
-            glVertex2f(POWERUP_SIZE/3, POWERUP_SIZE/4);
-            glEnd();
-            glLineWidth(1.0f);
-
-            // Glow effect
-            glEnable(GL_BLEND);
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-            glColor4f(0.0f, 0.7f, 1.0f, 0.3f);  // Semi-transparent cyan
-            glBegin(GL_TRIANGLE_FAN);
-            glVertex2f(0, 0);
-            for (int i = 0; i <= CIRCLE_SEGMENTS; i++) {
-                float angle = i * 2.0f * M_PI / CIRCLE_SEGMENTS;
-                glVertex2f(cos(angle) * POWERUP_SIZE * 1.5f, sin(angle) * POWERUP_SIZE * 1.5f);
-            }
-            glEnd();
-            glDisable(GL_BLEND);
+void publishFrame(std::chrono::steady_clock::time_point tickTime) {
+    FrameSnapshot& next = snapshots.writeBuffer();
+    next.scene.capture(world);
+    next.backgroundScroll = backgroundScroll;
+    next.backgroundScrollPrev = backgroundScrollPrev;
+    next.tickTime = tickTime;
+    next.run = run;
+    next.presses = presses;
+    next.lastPress = lastPress;
+    // The overlay refreshes twice a second, so the stats need not be fresher
+    if (simThreadMode && simStatsAge-- <= 0) {
+        for (int phase = 0; phase < PHASE_DRAW; phase++) {
+            next.simStats[phase] = simProfiler.stats(ProfilePhase(phase));
         }
-
-        glPopMatrix();
+        simStatsAge = 30;
+    }
+    snapshots.publish();
 }
 
-void drawGround() {
-    glColor3f(0.5f, 0.35f, 0.05f);
-    glBegin(GL_QUADS);
-    glVertex2f(0, 0);
-    glVertex2f(WINDOW_WIDTH, 0);
-    glVertex2f(WINDOW_WIDTH, GROUND_HEIGHT);
-    glVertex2f(0, GROUND_HEIGHT);
-    glEnd();
-
-    // Ground details
-    glColor3f(0.6f, 0.4f, 0.1f);
-    glBegin(GL_LINES);
-    for (int i = 0; i < WINDOW_WIDTH; i += 50) {
-        glVertex2f(i, GROUND_HEIGHT);
-        glVertex2f(i + 25, GROUND_HEIGHT - 10);
-    }
-    glEnd();
+static void simulationLoop() {
+    while (simRunning) {
+        simulate();
+        if (paused || world.gameOver) {
+            std::unique_lock<std::mutex> lock(simWakeMutex);
+            simWake.wait(lock, [] { return !simRunning || restartRequested || (!paused && !world.gameOver); });
+        } else {
+            std::this_thread::sleep_until(stepClock.nextTick());
+        }
+    }
 }
 
-void drawBoundaries() {
-    // Upper boundary
-    glColor3f(0.5f, 0.5f, 0.5f);
-    glBegin(GL_QUAD_STRIP);
-    for (int i = 0; i <= WINDOW_WIDTH; i += 50) {
-        glVertex2f(i, WINDOW_HEIGHT);
-        glVertex2f(i, WINDOW_HEIGHT - BOUNDARY_HEIGHT);
-    }
-    glEnd();
-
-    glColor3f(0.7f, 0.7f, 0.7f);
-    glBegin(GL_TRIANGLES);
-    for (int i = 0; i < WINDOW_WIDTH; i += 100) {
-        glVertex2f(i, WINDOW_HEIGHT - BOUNDARY_HEIGHT);
-        glVertex2f(i + 50, WINDOW_HEIGHT - BOUNDARY_HEIGHT);
-        glVertex2f(i + 25, WINDOW_HEIGHT - BOUNDARY_HEIGHT - 20);
-    }
-    glEnd();
-
-    glColor3f(0.6f, 0.6f, 0.6f);
-    glBegin(GL_POINTS);
-    for (int i = 0; i < WINDOW_WIDTH; i += 25) {
-        glVertex2f(i, WINDOW_HEIGHT - BOUNDARY_HEIGHT/2);
-    }
-    glEnd();
-
-    glColor3f(0.4f, 0.4f, 0.4f);
-    glBegin(GL_LINES);
-    for (int i = 0; i < WINDOW_WIDTH; i += 75) {
-        glVertex2f(i, WINDOW_HEIGHT);
-        glVertex2f(i + 50, WINDOW_HEIGHT - BOUNDARY_HEIGHT);
-    }
-    glEnd();
-
-    // Lower boundary (just above ground)
-    glColor3f(0.4f, 0.4f, 0.4f);
-    glBegin(GL_QUAD_STRIP);
-    for (int i = 0; i <= WINDOW_WIDTH; i += 50) {
-        glVertex2f(i, GROUND_HEIGHT);
-        glVertex2f(i, GROUND_HEIGHT + BOUNDARY_HEIGHT);
-    }
-    glEnd();
-
-    glColor3f(0.6f, 0.6f,
- 0.6f);
-    glBegin(GL_TRIANGLES);
-    for (int i = 0; i < WINDOW_WIDTH; i += 100) {
-        glVertex2f(i, GROUND_HEIGHT + BOUNDARY_HEIGHT);
-        glVertex2f(i + 50, GROUND_HEIGHT + BOUNDARY_HEIGHT);
-        glVertex2f(i + 25, GROUND_HEIGHT + BOUNDARY_HEIGHT + 20);
-    }
-    glEnd();
-
-    glColor3f(0.5f, 0.5f, 0.5f);
-    glBegin(GL_POINTS);
-    for (int i = 0; i < WINDOW_WIDTH; i += 25) {
-        glVertex2f(i, GROUND_HEIGHT + BOUNDARY_HEIGHT/2);
-    }
-    glEnd();
-
-    glColor3f(0.3f, 0.3f, 0.3f);
-    glBegin(GL_LINES);
-    for (int i = 0; i < WINDOW_WIDTH; i += 75) {
-        glVertex2f(i, GROUND_HEIGHT);
-        glVertex2f(i + 50, GROUND_HEIGHT + BOUNDARY_HEIGHT);
-    }
-    glEnd();
+static void stopCapture() {
+    // Frames still in GL are lost once the window has gone
+    bool ok = video.close();
+    printf("Captured %lld frames to %s (%lld dropped)%s\n", video.framesWritten(), capturePath,
+           video.framesDropped(), ok ? "" : ", with write errors");
 }
 
-void drawHUD() {
-    // Draw health
-    glColor3f(1.0f, 0.0f, 0.0f);
-    for (int i = 0; i < health; i++) {
-        glPushMatrix();
-        glTranslatef(30 + i * 30, WINDOW_HEIGHT - BOUNDARY_HEIGHT/2, 0);
-
-        // Heart shape (Polygon)
-        glBegin(GL_POLYGON);
-        for (int j = 0; j < 20; j++) {
-            float angle = 2.0f * 3.1415926f * float(j) / 20;
-            float x = 16 * pow(sin(angle), 3);
-            float y = 13 * cos(angle) - 5 * cos(2*angle) - 2 * cos(3*angle) - cos(4*angle);
-            glVertex2f(x, y);
-        }
-        glEnd();
-
-        // Heart outline (Line Loop)
-        glColor3f(0.8f, 0.0f, 0.0f);
-        glBegin(GL_LINE_LOOP);
-        for (int j = 0; j < 20; j++) {
-            float angle = 2.0f * 3.1415926f * float(j) / 20;
-            float x = 16 * pow(sin(angle), 3);
-            float y = 13 * cos(angle) - 5 * cos(2*angle) - 2 * cos(3*angle) - cos(4*angle);
-            glVertex2f(x, y);
-        }
-        glEnd();
-
-        glPopMatrix();
+static void stopSimulation() {
+    {
+        std::lock_guard<std::mutex> lock(simWakeMutex);
+        simRunning = false;
     }
-
-    // Draw score
-    glColor3f(1.0f, 1.0f, 1.0f);
-    glRasterPos2f(WINDOW_WIDTH - 100, WINDOW_HEIGHT - BOUNDARY_HEIGHT/2);
-    std::string scoreStr = "Score: " + std::to_string(score);
-    for (char c : scoreStr) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, c);
+    simWake.notify_one();
+    if (simThread.joinable()) {
+        simThread.join();
     }
+}
 
-    // Draw time
-    glColor3f(1.0f, 1.0f, 1.0f);
-    glRasterPos2f(WINDOW_WIDTH / 2 - 30, WINDOW_HEIGHT - BOUNDARY_HEIGHT/2);
-    std::string timeStr = "Time: " + std::to_string(gameTime);
-    for (char c : timeStr) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, c);
+void keyboard(unsigned char key, int x, int y) {
+    if (key == ' ') {
+        inputQueue.push(INPUT_JUMP, true, InputQueue::Clock::now());
     }
-
-    // Draw power-up status
-    if (coinMagnet) {
-        glColor3f(0.0f, 1.0f, 1.0f);
-        glRasterPos2f(10, WINDOW_HEIGHT - BOUNDARY_HEIGHT - 20);
-        std::string coinMagnetStr = "Coin Magnet: " + std::to_string(coinMagnetTime);
-        for (char c : coinMagnetStr) {
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, c);
-        }
+    if (key == 'd' || key == 'D') {
+        inputQueue.push(INPUT_DUCK, true, InputQueue::Clock::now());
     }
-    if (doublePoints) {
-        glColor3f(1.0f, 1.0f, 0.0f);
-        glRasterPos2f(10, WINDOW_HEIGHT - BOUNDARY_HEIGHT - 40);
-        std::string doublePointsStr = "Double Points: " + std::to_string(doublePointsTime);
-        for (char c : doublePointsStr) {
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, c);
+    if (key == 'r' || key == 'R') {
+        if (frame && frame->scene.gameOver) {
+            requestRestart();
         }
     }
+    if (key == 'p' || key == 'P') {
+        setPaused(!paused);
+    }
 }
 
-void updateGame() {
-    // Update player position
-    if (isJumping) {
-        playerY += jumpVelocity;
-        jumpVelocity -= GRAVITY;
-        if (playerY <= GROUND_HEIGHT) {
-            playerY = GROUND_HEIGHT;
-            isJumping = false;
-            jumpVelocity = 0;
-        }
+void keyboardUp(unsigned char key, int x, int y) {
+    if (key == 'd' || key == 'D') {
+        inputQueue.push(INPUT_DUCK, false, InputQueue::Clock::now());
     }
+}
 
-    // Move and animate objects
-    for (auto& obj : obstacles) {
-        if (obj.active) {
-            obj.x -= gameSpeed;
-            if (obj.x < -OBSTACLE_WIDTH) obj.active = false;
-        }
+void specialKey(int key, int x, int y) {
+    if (key == GLUT_KEY_F3) {
+        showProfiler = !showProfiler;
+        overlayAge = 0;
+        glutPostRedisplay(); // Shows even while idle
     }
+}
 
-    for (auto& obj : collectables) {
-        if (obj.active) {
-            obj.x -= gameSpeed;
-            obj.animationOffset = sin(glutGet(GLUT_ELAPSED_TIME) * 0.005f) * 5.0f;
-            if (obj.x < -COLLECTABLE_SIZE) obj.active = false;
-
-            // Coin magnet effect
-            if (coinMagnet && obj.x > playerX) {
-                float dx = playerX - obj.x;
-                float dy = playerY - obj.y;
-                float distance = sqrt(dx * dx + dy * dy);
+void startGame() {
+    if (replayPath) {
+        world.seed = replay.seed;
+    } else if (fixedSeed) {
+        world.seed = seedOption;
+    } else {
+        world.seed = uint64_t(time(0)) ^ uint64_t(std::chrono::steady_clock::now().time_since_epoch().count());
+    }
+    world.reset();
+    backgroundScroll = 0;
+    backgroundScrollPrev = 0;
+    inputQueue.clear();
+    run++;
+    presses = 0;
+    world.profiler->clear();
+    if (recordPath) {
+        replay.begin(world.seed, level.hash());
+    }
+    publishFrame(std::chrono::steady_clock::now());
+}
 
-                // Increase magnet radius from 150 to, for example, 250
-                if (distance < 250) {
-                    obj.x += dx * 0.1f;
-                    obj.y += dy * 0.1f;
-                }
-            }
-        }
-    }
+// Queues a sound for whatever the last tick did. Never blocks.
+void playWorldSounds() {
+    uint32_t events = world.events;
+    world.events = 0;
+    if (events & EVENT_JUMP) audio.play(SOUND_JUMP);
+    if (events & EVENT_HIT) audio.play(SOUND_COLLISION);
+    if (events & (EVENT_COLLECT | EVENT_POWERUP)) audio.play(SOUND_COLLECT);
+    if (events & EVENT_LOSE) audio.play(SOUND_LOSE);
+    if (events & EVENT_WIN) audio.play(SOUND_WIN);
+}
 
-    for (auto& obj : powerups) {
-        if (obj.active) {
-            obj.x -= gameSpeed;
-            obj.animationOffset = cos(glutGet(GLUT_ELAPSED_TIME) * 0.005f) * 5.0f;
-            if (obj.x < -POWERUP_SIZE) obj.active = false;
+void finishGame() {
+    if (replayPath && world.tick == replay.ticks()) {
+        bool match = world.checksum() == replay.checksum;
+        printf("Replay %s the recording (checksum %016llx)\n", match ? "matches" : "DOES NOT MATCH",
+               (unsigned long long)world.checksum());
+    }
+    if (recordPath) {
+        replay.checksum = world.checksum();
+        if (replay.save(recordPath)) {
+            printf("Replay saved to %s (seed %llu, %lld ticks)\n", recordPath,
+                   (unsigned long long)replay.seed, replay.ticks());
+        } else {
+            fprintf(stderr, "Could not write replay %s\n", recordPath);
         }
     }
-
-    // Spawn new objects
-    spawnObjects();
-
-    // Check collisions
-    for (auto& obj : obstacles) {
-        if (obj.active &&
-            playerX < obj.x + OBSTACLE_WIDTH/2 && playerX + PLAYER_WIDTH > obj.x - OBSTACLE_WIDTH/2 &&
-            playerY < obj.y + (obj.isHighObstacle ? OBSTACLE_HEIGHT * 1.5 : OBSTACLE_HEIGHT) &&
-            playerY + (isDucking ? PLAYER_DUCK_HEIGHT : PLAYER_HEIGHT+10) > obj.y) {
-            health--;
-            obj.active = false;
-            if (health <= 0) {
-                gameOver = true;
-            }
-            playerX = obj.x - PLAYER_WIDTH - 5; // Move player back slightly
-            break; // Exit the loop after collision
+    if (profileCsvPath) {
+        if (world.profiler->writeCsv(profileCsvPath)) {
+            printf("Frame timings saved to %s\n", profileCsvPath);
+        } else {
+            fprintf(stderr, "Could not write %s\n", profileCsvPath);
         }
     }
+}
 
-    for (auto& obj : collectables) {
-        if (obj.active &&
-            playerX < obj.x + COLLECTABLE_SIZE/2 && playerX + PLAYER_WIDTH > obj.x - COLLECTABLE_SIZE/2 &&
-            playerY < obj.y + COLLECTABLE_SIZE && playerY + (isDucking ? PLAYER_DUCK_HEIGHT : PLAYER_HEIGHT) > obj.y) {
-            score += (doublePoints ? 2 : 1);
-            obj.active = false;
-        }
+// Ground and sky never change, so each is uploaded once and only redrawn.
+// With --parallax they scroll: the ground at game speed, the sky at half.
+void drawBackground(float alpha) {
+    float scroll = 0;
+    if (parallax) {
+        scroll = frame->backgroundScrollPrev + (frame->backgroundScroll - frame->backgroundScrollPrev) * alpha;
     }
+    groundLayer.draw(-fmodf(scroll, BACKGROUND_PERIOD), 0);
+    skyLayer.draw(-fmodf(scroll * 0.5f, BACKGROUND_PERIOD), 0);
+}
 
-    for (auto& obj : powerups) {
-        if (obj.active &&
-            playerX < obj.x + POWERUP_SIZE/2 && playerX + PLAYER_WIDTH > obj.x - POWERUP_SIZE/2 &&
-            playerY < obj.y + POWERUP_SIZE && playerY + (isDucking ? PLAYER_DUCK_HEIGHT : PLAYER_HEIGHT) > obj.y) {
-            if (obj.isHighObstacle) { // Using isHighObstacle to differentiate between powerup types
-                coinMagnet = true;
-                coinMagnetTime = POWERUP_DURATION;
-            } else {
-                doublePoints = true;
-                doublePointsTime = POWERUP_DURATION;
-            }
-            obj.active = false;
-        }
-    }
+void drawHUD() {
+    hudText.clear();
+    const SceneState& scene = frame->scene;
+    scoreLabel.emit(textRenderer, scene.score, hudText);
+    timeLabel.emit(textRenderer, scene.gameTime, hudText);
 
-    // Update power-up timers
-    if (coinMagnet) {
-        coinMagnetTime--;
-        if (coinMagnetTime <= 0) {
-            coinMagnet = false;
-        }
+    // Draw power-up status
+    if (scene.coinMagnet) {
+        coinMagnetLabel.emit(textRenderer, scene.coinMagnetTime, hudText);
     }
-    if (doublePoints) {
-        doublePointsTime--;
-        if (doublePointsTime <= 0) {
-            doublePoints = false;
-        }
+    if (scene.doublePoints) {
+        doublePointsLabel.emit(textRenderer, scene.doublePointsTime, hudText);
     }
-
-    // Update game state
-    gameTime--;
-    if (gameTime <= 0) {
-        gameOver = true;
+    if (paused) {
+        pausedLabel.emit(textRenderer, hudText);
+        resumeLabel.emit(textRenderer, hudText);
     }
-
-    // Increase game speed over time
-    gameSpeed += 0.001f;
+    textRenderer.draw(hudText);
 }
 
-void spawnObjects() {
-    if (rand() % 800 < 2) {  // Now approximately 0.5% chance to spawn an obstacle per frame
-        bool isHigh = rand() % 2 == 0;
-        obstacles.push_back({WINDOW_WIDTH, float(GROUND_HEIGHT + (isHigh ? OBSTACLE_HEIGHT : 0)), true, 0, isHigh});
-    }
-    if (rand() % 200 < 3) {
-        collectables.push_back({WINDOW_WIDTH, float(GROUND_HEIGHT + rand() % 100), true, 0, false});
-    }
-
-    if (rand() % 1200 < 5) {
-        bool isCoinMagnet = rand() % 2 == 0;
-        powerups.push_back({WINDOW_WIDTH, float(GROUND_HEIGHT + rand() % 100), true, 0, isCoinMagnet});
+void drawProfilerOverlay() {
+    // Percentiles over a few hundred frames; refresh twice a second
+    if (overlayAge-- <= 0) {
+        overlayText.clear();
+        for (int phase = 0; phase < PHASE_COUNT; phase++) {
+            char line[96];
+            bool simulated = simThreadMode && phase < PHASE_DRAW;
+            PhaseStats stats = simulated ? frame->simStats[phase] : profiler.stats(ProfilePhase(phase));
+            snprintf(line, sizeof(line), "%-8s min %6.3f  avg %6.3f  p99 %6.3f ms",
+                     phaseName(ProfilePhase(phase)), stats.minMs, stats.avgMs, stats.p99Ms);
+            textRenderer.layout(FONT_SMALL, line, WINDOW_WIDTH - 290, WINDOW_HEIGHT - BOUNDARY_HEIGHT - 40 - phase * 14,
+                                0.0f, 1.0f, 0.0f, overlayText);
+        }
+        if (measureLatency) {
+            char line[96];
+            PhaseStats stats = latency.stats();
+            snprintf(line, sizeof(line), "%-8s min %6.3f  avg %6.3f  p99 %6.3f ms",
+                     "input", stats.minMs, stats.avgMs, stats.p99Ms);
+            textRenderer.layout(FONT_SMALL, line, WINDOW_WIDTH - 290, WINDOW_HEIGHT - BOUNDARY_HEIGHT - 40 - PHASE_COUNT * 14,
+                                0.0f, 1.0f, 0.0f, overlayText);
+        }
+        overlayAge = 30;
     }
-}
-
-void restartGame() {
-    playerX = 100;
-    playerY = GROUND_HEIGHT;
-    isJumping = false;
-    isDucking = false;
-    jumpVelocity = 0;
-    score = 0;
-    health = MAX_HEALTH;
-    gameTime = GAME_DURATION;
-    gameSpeed = INITIAL_GAME_SPEED;
-    gameOver = false;
-    coinMagnet = false;
-    coinMagnetTime = 0;
-    doublePoints = false;
-    doublePointsTime = 0;
-    obstacles.clear();
-    collectables.clear();
-    powerups.clear();
+    textRenderer.draw(overlayText);
 }
 
 void drawGameOver() {
-    glColor3f(1.0f, 1.0f, 1.0f);
-    glRasterPos2f(WINDOW_WIDTH / 2 - 50, WINDOW_HEIGHT / 2);
-    std::string gameOverStr;
-    if (gameTime <= 0) {
-        gameOverStr = "GAME END";
-    } else if (health <= 0) {
-        gameOverStr = "GAME LOST";
+    hudText.clear();
+    if (frame->scene.gameTime <= 0) {
+        gameEndLabel.emit(textRenderer, hudText);
+    } else if (frame->scene.health <= 0) {
+        gameLostLabel.emit(textRenderer, hudText);
     } else {
-        gameOverStr = "GAME OVER";  // Fallback, shouldn't normally occur
-    }
-    for (char c : gameOverStr) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, c);
-    }
-
-    glRasterPos2f(WINDOW_WIDTH / 2 - 70, WINDOW_HEIGHT / 2 - 30);
-    std::string scoreStr = "Final Score: " + std::to_string(score);
-    for (char c : scoreStr) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, c);
+        gameOverLabel.emit(textRenderer, hudText);  // Fallback, shouldn't normally occur
     }
+    finalScoreLabel.emit(textRenderer, frame->scene.score, hudText);
 
     // Draw restart button
-    glColor3f(0.0f, 1.0f, 0.0f);
-    glBegin(GL_QUADS);
-    glVertex2f(WINDOW_WIDTH / 2 - 60, WINDOW_HEIGHT / 2 - 80);
-    glVertex2f(WINDOW_WIDTH / 2 + 60, WINDOW_HEIGHT / 2 - 80);
-    glVertex2f(WINDOW_WIDTH / 2 + 60, WINDOW_HEIGHT / 2 - 50);
-    glVertex2f(WINDOW_WIDTH / 2 - 60, WINDOW_HEIGHT / 2 - 50);
-    glEnd();
-
-    glColor3f(0.0f, 0.0f, 0.0f);
-    glRasterPos2f(WINDOW_WIDTH / 2 - 30, WINDOW_HEIGHT / 2 - 70);
-    std::string restartStr = "Restart";
-    for (char c : restartStr) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, c);
+    if (restartButton.vertexCount() == 0) {
+        MeshBuilder button(restartButton);
+        button.color(0.0f, 1.0f, 0.0f);
+        button.quad(WINDOW_WIDTH / 2 - 60, WINDOW_HEIGHT / 2 - 80, WINDOW_WIDTH / 2 + 60, WINDOW_HEIGHT / 2 - 80,
+                    WINDOW_WIDTH / 2 + 60, WINDOW_HEIGHT / 2 - 50, WINDOW_WIDTH / 2 - 60, WINDOW_HEIGHT / 2 - 50);
     }
+    batchRenderer.draw(restartButton);
+
+    restartLabel.emit(textRenderer, hudText);
+    textRenderer.draw(hudText);
 }
 
 void mouseClick(int button, int state, int x, int y) {
-    if (gameOver && button == GLUT_LEFT_BUTTON && state == GLUT_DOWN) {
+    if (frame && frame->scene.gameOver && button == GLUT_LEFT_BUTTON && state == GLUT_DOWN) {
         int windowHeight = glutGet(GLUT_WINDOW_HEIGHT);
         y = windowHeight - y; // Invert y coordinate
 
         if (x >= WINDOW_WIDTH / 2 - 60 && x <= WINDOW_WIDTH / 2 + 60 &&
             y >= WINDOW_HEIGHT / 2 - 80 && y <= WINDOW_HEIGHT / 2 - 50) {
-            restartGame();
+            requestRestart();
         }
     }
 }
-int main(int argc, char** argv) {
-    glutInit(&argc, argv);
+
+static void usage(const char* program) {
+    fprintf(stderr,
+            "usage: %s [--fps N] [--tick-rate N] [--seed N] [--record FILE | --replay FILE]\n"
+            "          [--level FILE] [--profile-csv FILE] [--parallax] [--latency] [--mute]\n"
+            "          [--sim-thread] [--capture FILE] [--core-profile]\n"
+            "  --fps N        frames drawn per second (default 60)\n"
+            "  --tick-rate N  simulation steps per second (default %d; gameplay is tuned for %d)\n"
+            "  --seed N       seed every run with N instead of the clock\n"
+            "  --record FILE  save each finished run's seed and inputs to FILE\n"
+            "  --replay FILE  play back a recorded run; the keyboard only restarts\n"
+            "  --level FILE   load spawn rates, speed and tuning from a level file\n"
+            "  --profile-csv FILE  write per-frame phase timings to FILE at game over\n"
+            "  --parallax     scroll the ground and sky with the game\n"
+            "  --latency      measure key press to display latency (F3 shows it)\n"
+            "  --mute         no sound\n"
+            "  --sim-thread   step the simulation on its own thread, apart from drawing\n"
+            "  --capture FILE record every frame drawn, to FILE.y4m or a pattern like frame%%05d.ppm\n"
+            "  --core-profile draw through OpenGL 3.3 core shaders\n"
+            "P pauses and resumes; F3 toggles the frame timing overlay.\n",
+            program, TICK_RATE, TICK_RATE);
+    exit(1);
+}
+
+// The glyph atlas can only be drawn with bitmaps, which the core profile
+// lacks, so it is baked in a throwaway compatibility window first.
+static bool createCoreWindow() {
+    glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB);
+    glutInitWindowSize(1, 1);
+    int bootstrap = glutCreateWindow("2D Infinite Runner");
+    glutHideWindow();
+    textRenderer.bake();
+    glutDestroyWindow(bootstrap);
+
+#if defined(__APPLE__)
+    glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB | GLUT_3_2_CORE_PROFILE);
+#elif defined(GLUT_CORE_PROFILE)
+    glutInitContextVersion(3, 3);
+    glutInitContextProfile(GLUT_CORE_PROFILE);
     glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB);
+#else
+    fprintf(stderr, "This GLUT cannot create core profile contexts; run without --core-profile\n");
+    return false;
+#endif
     glutInitWindowSize(WINDOW_WIDTH, WINDOW_HEIGHT);
     glutCreateWindow("2D Infinite Runner");
+    if (!initCoreProfile()) {
+        return false;
+    }
+    setCoreView(WINDOW_WIDTH, WINDOW_HEIGHT, glutGet(GLUT_WINDOW_WIDTH), glutGet(GLUT_WINDOW_HEIGHT));
+    textRenderer.upload();
+    return true;
+}
+
+int main(int argc, char** argv) {
+    glutInit(&argc, argv);
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+            renderRate = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc) {
+            tickRate = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            fixedSeed = true;
+            seedOption = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (strcmp(argv[i], "--level") == 0 && i + 1 < argc) {
+            if (!level.load(argv[++i])) {
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--profile-csv") == 0 && i + 1 < argc) {
+            profileCsvPath = argv[++i];
+        } else if (strcmp(argv[i], "--parallax") == 0) {
+            parallax = true;
+        } else if (strcmp(argv[i], "--latency") == 0) {
+            measureLatency = true;
+        } else if (strcmp(argv[i], "--mute") == 0) {
+            mute = true;
+        } else if (strcmp(argv[i], "--sim-thread") == 0) {
+            simThreadMode = true;
+        } else if (strcmp(argv[i], "--capture") == 0 && i + 1 < argc) {
+            capturePath = argv[++i];
+        } else if (strcmp(argv[i], "--core-profile") == 0) {
+            coreProfile = true;
+        } else {
+            usage(argv[0]);
+        }
+    }
+    if (renderRate <= 0 || renderRate > 1000 || tickRate <= 0 || (recordPath && replayPath)) {
+        usage(argv[0]);
+    }
+    stepClock = FixedStepClock(tickRate);
+    if (replayPath && !replay.load(replayPath)) {
+        fprintf(stderr, "Could not read replay %s\n", replayPath);
+        return 1;
+    }
+    if (replayPath && replay.levelHash != level.hash()) {
+        fprintf(stderr, "%s was recorded on a different level; pass the same --level\n", replayPath);
+        return 1;
+    }
+
+    if (coreProfile) {
+        if (!createCoreWindow()) {
+            return 1;
+        }
+    } else {
+        glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB);
+        glutInitWindowSize(WINDOW_WIDTH, WINDOW_HEIGHT);
+        glutCreateWindow("2D Infinite Runner");
+        textRenderer.bake();
+        textRenderer.upload();
+    }
 
     glutDisplayFunc(display);
     glutReshapeFunc(reshape);
-    glutTimerFunc(0, timer, 0);
+    glutVisibilityFunc(visibility);
     glutKeyboardFunc(keyboard);
     glutKeyboardUpFunc(keyboardUp);
+    glutSpecialFunc(specialKey);
     glutMouseFunc(mouseClick);
 
-    srand(time(0));
+    buildSceneMeshes(sceneMeshes, coreProfile);
+    groundLayer.upload(sceneMeshes.ground);
+    skyLayer.upload(sceneMeshes.sky);
+    if (capturePath) {
+        // Frames are drawn at most renderRate times a second; idle time is
+        // not recorded
+        if (!video.open(capturePath, glutGet(GLUT_WINDOW_WIDTH), glutGet(GLUT_WINDOW_HEIGHT), renderRate)) {
+            return 1;
+        }
+        readback.start(video);
+        atexit(stopCapture);
+    }
+    // The WAVs sit next to the executable
+    std::string program = argv[0];
+    size_t slash = program.find_last_of("/\\");
+    audio.start(slash == std::string::npos ? "" : program.substr(0, slash + 1).c_str(), mute);
+
+    world.profiler = simThreadMode ? &simProfiler : &profiler;
+    world.level = &level;
+    world.spawns.startWorker(); // Keeps spawn generation off the tick
+    startGame();
+    if (simThreadMode) {
+        // A slow swap or driver stall then only delays drawing; ticks keep
+        // their schedule
+        simRunning = true;
+        simThread = std::thread(simulationLoop);
+        atexit(stopSimulation);
+    }
+    wake();
 
     glutMainLoop();
     return 0;
@@ -0,0 +1,63 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <cstdio>
+
+// A 60 s run at 60 fps is 3600 frames; keep a generous margin before
+// refusing new rows so an endless session cannot grow without bound.
+static const size_t MAX_FRAMES = 1 << 20;
+
+static const char* PHASE_NAMES[PHASE_COUNT] = {"step", "move", "spawn", "collide", "draw", "swap"};
+
+const char* phaseName(ProfilePhase phase) {
+    return PHASE_NAMES[phase];
+}
+
+Profiler::Profiler() {
+    frames.reserve(4096);
+    clear();
+}
+
+void Profiler::endFrame() {
+    if (frames.size() < MAX_FRAMES) {
+        frames.push_back(current);
+    }
+    current = FrameTiming();
+}
+
+void Profiler::clear() {
+    frames.clear();
+    current = FrameTiming();
+}
+
+PhaseStats Profiler::stats(ProfilePhase phase) const {
+    size_t count = std::min(frames.size(), size_t(STATS_WINDOW));
+    if (count == 0) return {0, 0, 0};
+
+    double samples[STATS_WINDOW];
+    double sum = 0;
+    for (size_t i = 0; i < count; i++) {
+        samples[i] = frames[frames.size() - count + i].ms[phase];
+        sum += samples[i];
+    }
+    size_t p99 = std::min(count - 1, count * 99 / 100);
+    std::nth_element(samples, samples + p99, samples + count);
+    return {*std::min_element(samples, samples + count), sum / count, samples[p99]};
+}
+
+bool Profiler::writeCsv(const char* path) const {
+    FILE* file = fopen(path, "w");
+    if (!file) return false;
+    fprintf(file, "frame,ticks");
+    for (int phase = 0; phase < PHASE_COUNT; phase++) {
+        fprintf(file, ",%s_ms", PHASE_NAMES[phase]);
+    }
+    fprintf(file, "\n");
+    for (size_t i = 0; i < frames.size(); i++) {
+        fprintf(file, "%zu,%d", i, frames[i].ticks);
+        for (int phase = 0; phase < PHASE_COUNT; phase++) {
+            fprintf(file, ",%.4f", frames[i].ms[phase]);
+        }
+        fprintf(file, "\n");
+    }
+    return fclose(file) == 0;
+}
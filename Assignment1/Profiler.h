@@ -0,0 +1,72 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <chrono>
+#include <vector>
+
+enum ProfilePhase {
+    PHASE_STEP,      // Whole RunnerWorld::step()
+    PHASE_MOVE,      // Scrolling, culling and the coin magnet
+    PHASE_SPAWN,     // spawnObjects()
+    PHASE_COLLIDE,   // Collision sweeps against the player
+    PHASE_DRAW,      // Building and submitting the frame in display()
+    PHASE_SWAP,      // glutSwapBuffers()
+    PHASE_COUNT
+};
+
+const char* phaseName(ProfilePhase phase);
+
+struct PhaseStats {
+    double minMs, avgMs, p99Ms;
+};
+
+// Per-frame, per-phase wall-clock timings. Phases may be entered several
+// times per frame (one step per owed tick); their times add up.
+class Profiler {
+public:
+    Profiler();
+
+    void add(ProfilePhase phase, double ms) { current.ms[phase] += ms; }
+    void countTick() { current.ticks++; }
+    // Closes the current frame's row and starts a new one.
+    void endFrame();
+    // Drops everything recorded so far, e.g. when a new run starts.
+    void clear();
+
+    // Over the most recent STATS_WINDOW frames.
+    PhaseStats stats(ProfilePhase phase) const;
+    // One row per frame since the last clear().
+    bool writeCsv(const char* path) const;
+
+    static const int STATS_WINDOW = 300;
+
+private:
+    struct FrameTiming {
+        double ms[PHASE_COUNT];
+        int ticks;
+    };
+
+    FrameTiming current;
+    std::vector<FrameTiming> frames;
+};
+
+// Adds the lifetime of the scope to a phase. A null profiler makes it free.
+class ScopedTimer {
+public:
+    ScopedTimer(Profiler* profiler, ProfilePhase phase) : profiler(profiler), phase(phase) {
+        if (profiler) start = std::chrono::steady_clock::now();
+    }
+    ~ScopedTimer() {
+        if (profiler) {
+            auto end = std::chrono::steady_clock::now();
+            profiler->add(phase, std::chrono::duration<double, std::milli>(end - start).count());
+        }
+    }
+
+private:
+    Profiler* profiler;
+    ProfilePhase phase;
+    std::chrono::steady_clock::time_point start;
+};
+
+#endif
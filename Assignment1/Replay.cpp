@@ -0,0 +1,84 @@
+#include "Replay.h"
+#include "ByteIO.h"
+#include <algorithm>
+#include <cstdio>
+
+static const char REPLAY_MAGIC[4] = {'R', 'N', 'R', 'P'};
+static const uint8_t REPLAY_VERSION = 4;
+
+void Replay::begin(uint64_t seed, uint64_t levelHash) {
+    this->seed = seed;
+    this->levelHash = levelHash;
+    checksum = 0;
+    inputs.clear();
+}
+
+RunnerInput Replay::at(long long tick) const {
+    if (tick < 0 || tick >= ticks()) return RunnerInput();
+    return RunnerInput::fromBits(inputs[tick]);
+}
+
+bool Replay::save(const char* path) const {
+    std::vector<uint8_t> out(REPLAY_MAGIC, REPLAY_MAGIC + 4);
+    out.push_back(REPLAY_VERSION);
+    putUnsigned(out, seed, 8);
+    putUnsigned(out, levelHash, 8);
+    putUnsigned(out, checksum, 8);
+    putUnsigned(out, uint32_t(inputs.size()), 4);
+
+    // Inputs change rarely, so run-length encode them
+    for (size_t i = 0; i < inputs.size();) {
+        size_t run = 1;
+        while (i + run < inputs.size() && inputs[i + run] == inputs[i]) run++;
+        out.push_back(inputs[i]);
+        putVarint(out, uint32_t(run));
+        i += run;
+    }
+
+    return writeFile(path, out);
+}
+
+bool Replay::load(const char* path) {
+    std::vector<uint8_t> data;
+    if (!readFile(path, data)) return false;
+
+    ByteReader reader{data};
+    uint64_t version, fileSeed, fileLevelHash, fileChecksum, tickCount;
+    if (data.size() < 4 || !std::equal(REPLAY_MAGIC, REPLAY_MAGIC + 4, data.begin())) return false;
+    reader.pos = 4;
+    if (!reader.getUnsigned(version, 1) || version != REPLAY_VERSION) return false;
+    if (!reader.getUnsigned(fileSeed, 8) || !reader.getUnsigned(fileLevelHash, 8) ||
+        !reader.getUnsigned(fileChecksum, 8) || !reader.getUnsigned(tickCount, 4)) {
+        return false;
+    }
+
+    // Walk the runs first, so a corrupt tick count is caught before it sizes
+    // an allocation: the runs actually present must add up to it exactly
+    size_t runsStart = reader.pos;
+    uint64_t covered = 0;
+    while (covered < tickCount) {
+        uint64_t bits;
+        uint32_t run;
+        if (!reader.getUnsigned(bits, 1) || !reader.getVarint(run)) return false;
+        if (run == 0 || covered + run > tickCount) return false;
+        covered += run;
+    }
+    if (reader.pos != data.size()) return false;
+
+    std::vector<uint8_t> decoded;
+    decoded.reserve(tickCount);
+    reader.pos = runsStart;
+    while (decoded.size() < tickCount) {
+        uint64_t bits = 0;
+        uint32_t run = 0;
+        reader.getUnsigned(bits, 1);
+        reader.getVarint(run);
+        decoded.insert(decoded.end(), run, uint8_t(bits));
+    }
+
+    seed = fileSeed;
+    levelHash = fileLevelHash;
+    checksum = fileChecksum;
+    inputs.swap(decoded);
+    return true;
+}
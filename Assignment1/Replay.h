@@ -0,0 +1,37 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "RunnerWorld.h"
+#include <cstdint>
+#include <vector>
+
+// A recorded run: the world seed plus the input applied on every tick.
+// Feeding the same inputs to a world reset with the same seed, on the same
+// level, reproduces the run bit for bit. The level's hash and the world's
+// checksum after the last tick are stored so playback can prove it.
+//
+// File layout (little-endian):
+//   "RNRP"  magic
+//   u8      version (4; earlier versions predate spawn schedules, jump
+//           buffering and the stored level and checksum)
+//   u64     seed
+//   u64     level hash (LevelConfig::hash())
+//   u64     final checksum (RunnerWorld::checksum() after the last tick)
+//   u32     tick count
+//   runs of [u8 input bits][varint length] until tick count is covered
+struct Replay {
+    uint64_t seed = 0;
+    uint64_t levelHash = 0;
+    uint64_t checksum = 0;
+    std::vector<uint8_t> inputs; // RunnerInput::bits() per tick
+
+    void begin(uint64_t seed, uint64_t levelHash);
+    void record(const RunnerInput& input) { inputs.push_back(input.bits()); }
+    RunnerInput at(long long tick) const;
+    long long ticks() const { return (long long)inputs.size(); }
+
+    bool save(const char* path) const;
+    bool load(const char* path);
+};
+
+#endif
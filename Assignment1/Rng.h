@@ -0,0 +1,37 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <cstdint>
+
+// PCG32 (XSH-RR variant): 64-bit state, 32-bit output. Owned per world so a
+// run is reproducible from its seed alone, on any platform and any thread.
+class Rng {
+public:
+    explicit Rng(uint64_t seed = 0) { reseed(seed); }
+
+    void reseed(uint64_t seed) {
+        state = 0;
+        next();
+        state += seed;
+        next();
+    }
+
+    uint32_t next() {
+        uint64_t old = state;
+        state = old * 6364136223846793005ULL + 1442695040888963407ULL;
+        uint32_t xorshifted = uint32_t(((old >> 18) ^ old) >> 27);
+        uint32_t rot = uint32_t(old >> 59);
+        return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+    }
+
+    // Uniform in [0, n) by multiply-shift; the bias is below 2^-20 for the
+    // small ranges the game uses.
+    int below(int n) {
+        return int((uint64_t(next()) * uint32_t(n)) >> 32);
+    }
+
+private:
+    uint64_t state;
+};
+
+#endif
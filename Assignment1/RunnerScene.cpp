@@ -0,0 +1,370 @@
+#include "RunnerScene.h"
+#include "GeometryTables.h"
+
+static const int BACKGROUND_WIDTH = WINDOW_WIDTH + BACKGROUND_PERIOD;
+
+static void buildGround(DrawBatch& mesh) {
+    MeshBuilder m(mesh);
+
+    m.color(0.5f, 0.35f, 0.05f);
+    m.quad(0, 0, BACKGROUND_WIDTH, 0, BACKGROUND_WIDTH, GROUND_HEIGHT, 0, GROUND_HEIGHT);
+
+    // Ground details
+    m.color(0.6f, 0.4f, 0.1f);
+    for (int i = 0; i < BACKGROUND_WIDTH; i += 50) {
+        m.line(i, GROUND_HEIGHT, i + 25, GROUND_HEIGHT - 10);
+    }
+
+    // Lower boundary (just above ground)
+    float bottom = GROUND_HEIGHT;
+    float top = GROUND_HEIGHT + BOUNDARY_HEIGHT;
+    m.color(0.4f, 0.4f, 0.4f);
+    for (int i = 0; i < BACKGROUND_WIDTH; i += 50) {
+        m.quad(i, bottom, i + 50, bottom, i + 50, top, i, top);
+    }
+
+    m.color(0.6f, 0.6f, 0.6f);
+    for (int i = 0; i < BACKGROUND_WIDTH; i += 100) {
+        m.triangle(i, top, i + 50, top, i + 25, top + 20);
+    }
+
+    m.color(0.5f, 0.5f, 0.5f);
+    for (int i = 0; i < BACKGROUND_WIDTH; i += 25) {
+        m.point(i, GROUND_HEIGHT + BOUNDARY_HEIGHT/2);
+    }
+
+    m.color(0.3f, 0.3f, 0.3f);
+    for (int i = 0; i < BACKGROUND_WIDTH; i += 75) {
+        m.line(i, bottom, i + 50, top);
+    }
+}
+
+static void buildSky(DrawBatch& mesh) {
+    MeshBuilder m(mesh);
+
+    // Upper boundary
+    float top = WINDOW_HEIGHT;
+    float bottom = WINDOW_HEIGHT - BOUNDARY_HEIGHT;
+    m.color(0.5f, 0.5f, 0.5f);
+    for (int i = 0; i < BACKGROUND_WIDTH; i += 50) {
+        m.quad(i, top, i + 50, top, i + 50, bottom, i, bottom);
+    }
+
+    m.color(0.7f, 0.7f, 0.7f);
+    for (int i = 0; i < BACKGROUND_WIDTH; i += 100) {
+        m.triangle(i, bottom, i + 50, bottom, i + 25, bottom - 20);
+    }
+
+    m.color(0.6f, 0.6f, 0.6f);
+    for (int i = 0; i < BACKGROUND_WIDTH; i += 25) {
+        m.point(i, WINDOW_HEIGHT - BOUNDARY_HEIGHT/2);
+    }
+
+    m.color(0.4f, 0.4f, 0.4f);
+    for (int i = 0; i < BACKGROUND_WIDTH; i += 75) {
+        m.line(i, top, i + 50, bottom);
+    }
+}
+
+static void buildPlayer(DrawBatch& mesh, float height) {
+    MeshBuilder m(mesh);
+
+    // Body (Quad)
+    m.color(0.0f, 0.0f, 1.0f);
+    m.quad(-PLAYER_WIDTH/2, 0, PLAYER_WIDTH/2, 0, PLAYER_WIDTH/2, height, -PLAYER_WIDTH/2, height);
+
+    // Head (Triangle)
+    m.color(1.0f, 0.8f, 0.6f);
+    m.triangle(-PLAYER_WIDTH/4, height, PLAYER_WIDTH/4, height, 0, height + PLAYER_HEAD_HEIGHT);
+
+    // Eye (Point)
+    m.color(0.0f, 0.0f, 0.0f);
+    m.point(PLAYER_WIDTH/8, height + PLAYER_WIDTH/4);
+
+    // Arm (Line)
+    m.color(0.0f, 0.0f, 0.8f);
+    m.line(PLAYER_WIDTH/2, height*3/4, PLAYER_WIDTH, height/2);
+}
+
+static void buildObstacle(DrawBatch& mesh, bool isHigh, bool shapes) {
+    MeshBuilder m(mesh, shapes);
+
+    float height = isHigh ? HIGH_OBSTACLE_HEIGHT : LOW_OBSTACLE_HEIGHT;
+    float width = OBSTACLE_WIDTH;
+
+    // Main body (Rectangle)
+    m.color(0.0f, 0.5f, 0.0f);  // Dark green
+    m.quad(-width/4, 0, width/4, 0, width/4, height, -width/4, height);
+
+    // Left arm (Triangle)
+    m.triangle(-width/4, height * 0.6f, -width/2, height * 0.8f, -width/4, height * 0.9f);
+
+    // Right arm (Triangle)
+    m.triangle(width/4, height * 0.5f, width/2, height * 0.7f, width/4, height * 0.8f);
+
+    // Spikes (Lines)
+    m.color(1.0f, 1.0f, 1.0f);  // White
+    for (float i = 0.1f; i < 1.0f; i += 0.2f) {
+        // Left side spikes
+        m.line(-width/4, height * i, -width/3, height * (i + 0.05f));
+
+        // Right side spikes
+        m.line(width/4, height * (i + 0.05f), width/3, height * (i + 0.1f));
+    }
+
+    // Top (small circle)
+    m.color(1.0f, 0.5f, 0.8f);  // Pink
+    if (m.shapes()) {
+        m.shape(SHAPE_DISC, 0, height, OBSTACLE_TOP_RADIUS);
+        return;
+    }
+    float top[2 * 37];
+    for (int i = 0; i <= 36; i++) {
+        top[2*i] = CACTUS_TOP[i].x * OBSTACLE_TOP_RADIUS;
+        top[2*i + 1] = CACTUS_TOP[i].y * OBSTACLE_TOP_RADIUS + height;
+    }
+    m.fan(top, 37);
+}
+
+static void buildCollectable(DrawBatch& mesh, bool shapes) {
+    MeshBuilder m(mesh, shapes);
+
+    // Outer circle (Polygon)
+    m.color(1.0f, 1.0f, 0.0f);
+    if (m.shapes()) {
+        m.shape(SHAPE_DISC, 0, 0, COLLECTABLE_SIZE/2);
+    } else {
+        float circle[2 * 16];
+        for (int i = 0; i < 16; i++) {
+            circle[2*i] = COIN_CIRCLE[i].x * COLLECTABLE_SIZE/2;
+            circle[2*i + 1] = COIN_CIRCLE[i].y * COLLECTABLE_SIZE/2;
+        }
+        m.fan(circle, 16);
+    }
+
+    // Inner star (Triangles), a pentagon in effect
+    m.color(1.0f, 0.8f, 0.0f);
+    if (m.shapes()) {
+        m.shape(SHAPE_PENTAGON, 0, 0, COLLECTABLE_SIZE / 3.0f);
+    } else {
+        for (int i = 0; i < 5; i++) {
+            Point2 p1 = STAR_POINTS[i];
+            Point2 p2 = STAR_POINTS[i + 1];
+            m.triangle(0, 0,
+                       p1.x * COLLECTABLE_SIZE/3, p1.y * COLLECTABLE_SIZE/3,
+                       p2.x * COLLECTABLE_SIZE/3, p2.y * COLLECTABLE_SIZE/3);
+        }
+    }
+
+    // Decorative lines (Line Strip)
+    m.color(1.0f, 0.5f, 0.0f);
+    float rays[2 * 12];
+    for (int i = 0; i <= 5; i++) {
+        float innerRadius = COLLECTABLE_SIZE/6;
+        float outerRadius = COLLECTABLE_SIZE/3;
+        rays[4*i] = STAR_POINTS[i].x * innerRadius;
+        rays[4*i + 1] = STAR_POINTS[i].y * innerRadius;
+        rays[4*i + 2] = STAR_POINTS[i].x * outerRadius;
+        rays[4*i + 3] = STAR_POINTS[i].y * outerRadius;
+    }
+    m.lineStrip(rays, 12);
+
+    // Center (Point)
+    m.point(0, 0);
+}
+
+static void buildCoinMagnet(DrawBatch& mesh) {
+    MeshBuilder m(mesh);
+
+    // Horseshoe shape
+    Vertex horseshoe[2 * (CIRCLE_SEGMENTS + 1)];
+    for (int i = 0; i <= CIRCLE_SEGMENTS; i++) {
+        float c = HALF_CIRCLE[i].x;
+        float s = HALF_CIRCLE[i].y;
+
+        // Outer edge (red)
+        m.color(0.8f - 0.2f * s, 0.2f, 0.2f);
+        horseshoe[2*i] = m.vertex(c * POWERUP_SIZE, s * POWERUP_SIZE);
+
+        // Inner edge (lighter red)
+        m.color(1.0f - 0.2f * s, 0.4f, 0.4f);
+        horseshoe[2*i + 1] = m.vertex(c * POWERUP_SIZE * 0.7f, s * POWERUP_SIZE * 0.7f);
+    }
+    m.strip(horseshoe, 2 * (CIRCLE_SEGMENTS + 1));
+
+    // Magnet poles (bright red)
+    m.color(1.0f, 0.2f, 0.2f);
+    // Left pole
+    m.quad(-POWERUP_SIZE, 0, -POWERUP_SIZE * 0.7f, 0,
+           -POWERUP_SIZE * 0.7f, -POWERUP_SIZE * 0.4f, -POWERUP_SIZE, -POWERUP_SIZE * 0.4f);
+    // Right pole
+    m.quad(POWERUP_SIZE * 0.7f, 0, POWERUP_SIZE, 0,
+           POWERUP_SIZE, -POWERUP_SIZE * 0.4f, POWERUP_SIZE * 0.7f, -POWERUP_SIZE * 0.4f);
+
+    // Magnetic field lines
+    m.color(0.9f, 0.4f, 0.4f, 0.7f);
+    for (int i = 0; i < 5; i++) {
+        float y = -POWERUP_SIZE * 0.5f - i * 0.1f * POWERUP_SIZE;
+        m.line(-POWERUP_SIZE, y, 0, y - POWERUP_SIZE * 0.2f);
+        m.line(0, y - POWERUP_SIZE * 0.2f, POWERUP_SIZE, y);
+    }
+
+    // Metallic shine
+    m.color(1.0f, 1.0f, 1.0f, 0.5f);
+    Vertex shine[2 * (CIRCLE_SEGMENTS / 2 + 1)];
+    for (int i = 0; i <= CIRCLE_SEGMENTS / 2; i++) {
+        float c = HALF_CIRCLE[i].x;
+        float s = HALF_CIRCLE[i].y;
+        shine[2*i] = m.vertex(c * POWERUP_SIZE * 0.9f, s * POWERUP_SIZE * 0.9f);
+        shine[2*i + 1] = m.vertex(c * POWERUP_SIZE * 0.8f, s * POWERUP_SIZE * 0.8f);
+    }
+    m.strip(shine, 2 * (CIRCLE_SEGMENTS / 2 + 1));
+}
+
+static void buildDoublePoints(DrawBatch& mesh, bool shapes) {
+    MeshBuilder m(mesh, shapes);
+
+    // Diamond shape
+    m.color(0.0f, 0.7f, 1.0f);  // Cyan color
+    const float diamond[] = {
+        0, POWERUP_SIZE,   // Top
+        POWERUP_SIZE, 0,   // Right
+        0, -POWERUP_SIZE,  // Bottom
+        -POWERUP_SIZE, 0,  // Left
+        0, POWERUP_SIZE,   // Back to top
+    };
+    m.fan(diamond, 5);
+
+    // Inner diamond (for depth effect)
+    m.color(0.0f, 0.9f, 1.0f);  // Lighter cyan
+    const float inner[] = {
+        0, POWERUP_SIZE * 0.8f,
+        POWERUP_SIZE * 0.8f, 0,
+        0, -POWERUP_SIZE * 0.8f,
+        -POWERUP_SIZE * 0.8f, 0,
+        0, POWERUP_SIZE * 0.8f,
+    };
+    m.fan(inner, 5);
+
+    // "2x" symbol
+    m.color(1.0f, 1.0f, 1.0f);  // White color
+    // '2'
+    m.wideLine(-POWERUP_SIZE/4, POWERUP_SIZE/4, 0, POWERUP_SIZE/4);
+    m.wideLine(0, POWERUP_SIZE/4, 0, 0);
+    m.wideLine(0, 0, -POWERUP_SIZE/4, 0);
+    m.wideLine(-POWERUP_SIZE/4, 0, -POWERUP_SIZE/4, -POWERUP_SIZE/4);
+    m.wideLine(-POWERUP_SIZE/4, -POWERUP_SIZE/4, 0, -POWERUP_SIZE/4);
+    // 'x'
+    m.wideLine(POWERUP_SIZE/8, POWERUP_SIZE/4, POWERUP_SIZE/3, -POWERUP_SIZE/4);
+    m.wideLine(POWERUP_SIZE/8, -POWERUP_SIZE/4, POWERUP_SIZE/3, POWERUP_SIZE/4);
+
+    // Glow effect
+    m.color(0.0f, 0.7f, 1.0f, 0.3f);  // Semi-transparent cyan
+    if (m.shapes()) {
+        m.shape(SHAPE_DISC, 0, 0, POWERUP_SIZE * 1.5f);
+        return;
+    }
+    float glow[2 * (CIRCLE_SEGMENTS + 2)];
+    glow[0] = 0;
+    glow[1] = 0;
+    for (int i = 0; i <= CIRCLE_SEGMENTS; i++) {
+        glow[2*i + 2] = GLOW_CIRCLE[i].x * POWERUP_SIZE * 1.5f;
+        glow[2*i + 3] = GLOW_CIRCLE[i].y * POWERUP_SIZE * 1.5f;
+    }
+    m.fan(glow, CIRCLE_SEGMENTS + 2);
+}
+
+static void buildHeart(DrawBatch& mesh, bool shapes) {
+    MeshBuilder m(mesh, shapes);
+    if (m.shapes()) {
+        m.color(1.0f, 0.0f, 0.0f);
+        m.shape(SHAPE_HEART, 0, 0, 1);
+        m.color(0.8f, 0.0f, 0.0f);
+        m.shape(SHAPE_HEART_OUTLINE, 0, 0, 1);
+        return;
+    }
+
+    float outline[2 * 20];
+    for (int j = 0; j < 20; j++) {
+        outline[2*j] = HEART_OUTLINE[j].x;
+        outline[2*j + 1] = HEART_OUTLINE[j].y;
+    }
+
+    // Heart shape (Polygon)
+    m.color(1.0f, 0.0f, 0.0f);
+    m.fan(outline, 20);
+
+    // Heart outline (Line Loop)
+    m.color(0.8f, 0.0f, 0.0f);
+    m.lineLoop(outline, 20);
+}
+
+void buildSceneMeshes(SceneMeshes& meshes, bool shapes) {
+    buildGround(meshes.ground);
+    buildSky(meshes.sky);
+    buildPlayer(meshes.playerStanding, PLAYER_HEIGHT);
+    buildPlayer(meshes.playerDucking, PLAYER_DUCK_HEIGHT);
+    buildObstacle(meshes.obstacleLow, false, shapes);
+    buildObstacle(meshes.obstacleHigh, true, shapes);
+    buildCollectable(meshes.collectable, shapes);
+    buildCoinMagnet(meshes.coinMagnet);
+    buildDoublePoints(meshes.doublePoints, shapes);
+    buildHeart(meshes.heart, shapes);
+}
+
+static float lerp(float from, float to, float alpha) {
+    return from + (to - from) * alpha;
+}
+
+SceneState::SceneState(int poolCapacity)
+    : obstacles(poolCapacity), collectables(poolCapacity), powerups(poolCapacity) {}
+
+void SceneState::capture(const RunnerWorld& world) {
+    playerX = world.playerX;
+    playerY = world.playerY;
+    playerPrevX = world.playerPrevX;
+    playerPrevY = world.playerPrevY;
+    isDucking = world.isDucking;
+    score = world.score;
+    health = world.health;
+    gameTime = world.gameTime;
+    gameOver = world.gameOver;
+    coinMagnet = world.coinMagnet;
+    coinMagnetTime = world.coinMagnetTime;
+    doublePoints = world.doublePoints;
+    doublePointsTime = world.doublePointsTime;
+    tick = world.tick;
+    animation = world.animation;
+    obstacles.copyFrom(world.obstacles);
+    collectables.copyFrom(world.collectables);
+    powerups.copyFrom(world.powerups);
+}
+
+void emitScene(const SceneState& scene, const SceneMeshes& meshes, DrawBatch& batch, float alpha) {
+    batch.append(scene.isDucking ? meshes.playerDucking : meshes.playerStanding,
+                 lerp(scene.playerPrevX, scene.playerX, alpha), lerp(scene.playerPrevY, scene.playerY, alpha));
+
+    const EntityPool& obstacles = scene.obstacles;
+    for (int i = 0; i < obstacles.size(); i++) {
+        batch.append(obstacles.isHighObstacle[i] ? meshes.obstacleHigh : meshes.obstacleLow,
+                     lerp(obstacles.prevX[i], obstacles.x[i], alpha), lerp(obstacles.prevY[i], obstacles.y[i], alpha));
+    }
+
+    const EntityPool& collectables = scene.collectables;
+    for (int i = 0; i < collectables.size(); i++) {
+        batch.append(meshes.collectable, lerp(collectables.prevX[i], collectables.x[i], alpha),
+                     lerp(collectables.prevY[i], collectables.y[i], alpha) + COLLECTABLE_SIZE/2);
+    }
+
+    const EntityPool& powerups = scene.powerups;
+    for (int i = 0; i < powerups.size(); i++) {
+        batch.append(powerups.isHighObstacle[i] ? meshes.coinMagnet : meshes.doublePoints,
+                     lerp(powerups.prevX[i], powerups.x[i], alpha),
+                     lerp(powerups.prevY[i], powerups.y[i], alpha) + scene.animation.powerupBob(powerups.phase[i]));
+    }
+
+    // Health
+    for (int i = 0; i < scene.health; i++) {
+        batch.append(meshes.heart, 30 + i * 30, WINDOW_HEIGHT - BOUNDARY_HEIGHT/2);
+    }
+}
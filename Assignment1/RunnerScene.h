@@ -0,0 +1,65 @@
+#ifndef RUNNER_SCENE_H
+#define RUNNER_SCENE_H
+
+#include "DrawBatch.h"
+#include "RunnerWorld.h"
+
+// Every background pattern repeats after this many pixels, so a layer built
+// this much wider than the window can scroll forever by wrapping its offset.
+const int BACKGROUND_PERIOD = 300;
+
+// Every shape the game draws, built once at startup in object space.
+struct SceneMeshes {
+    // Background layers, in screen space and BACKGROUND_PERIOD wider than the
+    // window. ground holds the ground and the boundary just above it; sky the
+    // boundary along the top of the screen.
+    DrawBatch ground;
+    DrawBatch sky;
+
+    DrawBatch playerStanding;
+    DrawBatch playerDucking;
+    DrawBatch obstacleLow;
+    DrawBatch obstacleHigh;
+    DrawBatch collectable;
+    DrawBatch coinMagnet;
+    DrawBatch doublePoints;
+    DrawBatch heart;
+};
+
+// With shapes, circles, the coin's star and hearts become ShapeInstances for
+// the core-profile renderer instead of 16 to 37 segment polygons.
+void buildSceneMeshes(SceneMeshes& meshes, bool shapes = false);
+
+// The part of a world that gets drawn, copied out after a tick so a frame
+// can be drawn from it while the world moves on.
+struct SceneState {
+    float playerX = 0, playerY = 0;
+    float playerPrevX = 0, playerPrevY = 0;
+    bool isDucking = false;
+    int score = 0;
+    int health = 0;
+    int gameTime = 0;
+    bool gameOver = false;
+    bool coinMagnet = false;
+    int coinMagnetTime = 0;
+    bool doublePoints = false;
+    int doublePointsTime = 0;
+    long long tick = 0;
+    AnimationClock animation;
+
+    EntityPool obstacles;
+    EntityPool collectables;
+    EntityPool powerups;
+
+    // poolCapacity must be at least the captured world's
+    explicit SceneState(int poolCapacity = POOL_CAPACITY);
+
+    void capture(const RunnerWorld& world);
+};
+
+// Appends the player, all live objects and the health hearts to batch, with
+// positions blended alpha of the way from the previous tick to the current
+// one. Touches no GL state, so the result can be drawn by any backend.
+void emitScene(const SceneState& scene, const SceneMeshes& meshes, DrawBatch& batch, float alpha = 1.0f);
+
+#endif
@@ -0,0 +1,274 @@
+#include "RunnerWorld.h"
+#include "SimdKernels.h"
+#include <algorithm>
+
+RunnerWorld::RunnerWorld(int poolCapacity)
+    : obstacles(poolCapacity), collectables(poolCapacity), powerups(poolCapacity),
+      hits(poolCapacity) {}
+
+Box RunnerWorld::playerBox() const {
+    float height = (isDucking ? PLAYER_DUCK_HEIGHT : PLAYER_HEIGHT) + PLAYER_HEAD_HEIGHT;
+    return {playerX - PLAYER_WIDTH/2.0f, playerY, playerX + PLAYER_WIDTH/2.0f, playerY + height};
+}
+
+// Fills hits with the indices of pool objects overlapping target, in
+// ascending order, and returns how many there are. Kill them from the back
+// so the indices still to come stay valid.
+static int findHits(const EntityPool& pool, const ObjectShape& shape, const Box& target, std::vector<int>& hits) {
+    return findOverlaps(pool.x.data(), pool.y.data(), pool.isHighObstacle.data(), pool.size(), shape, target, hits.data());
+}
+
+// Scrolls the whole pool left and recycles whatever has passed limit.
+static void scrollPool(EntityPool& pool, float speed, float limit, std::vector<int>& hits) {
+    int culled = scrollAndCull(pool.x.data(), pool.size(), speed, limit, hits.data());
+    for (int i = culled - 1; i >= 0; i--) {
+        pool.kill(hits[i]);
+    }
+}
+
+bool RunnerWorld::jump() {
+    if (isJumping || playerY != GROUND_HEIGHT) return false;
+    isJumping = true;
+    jumpVelocity = level->jumpVelocity;
+    events |= EVENT_JUMP;
+    return true;
+}
+
+void RunnerWorld::setDucking(bool ducking) {
+    isDucking = ducking;
+}
+
+static void storePreviousPositions(EntityPool& pool) {
+    std::copy(pool.x.begin(), pool.x.begin() + pool.size(), pool.prevX.begin());
+    std::copy(pool.y.begin(), pool.y.begin() + pool.size(), pool.prevY.begin());
+}
+
+void RunnerWorld::applyInput(const RunnerInput& input) {
+    // A press that comes too early is buffered and fires on the first tick
+    // the player is back on the ground
+    if (input.jump) {
+        jumpBuffer = JUMP_BUFFER_TICKS;
+    }
+    if (jumpBuffer > 0) {
+        jumpBuffer = jump() ? 0 : jumpBuffer - 1;
+    }
+    setDucking(input.duck);
+}
+
+void RunnerWorld::step() {
+    ScopedTimer stepTimer(profiler, PHASE_STEP);
+    if (profiler) {
+        profiler->countTick();
+    }
+
+    moveObjects();
+
+    // Spawn new objects
+    spawnObjects();
+
+    checkCollisions();
+
+    // Update power-up timers
+    if (coinMagnet) {
+        coinMagnetTime--;
+        if (coinMagnetTime <= 0) {
+            coinMagnet = false;
+        }
+    }
+    if (doublePoints) {
+        doublePointsTime--;
+        if (doublePointsTime <= 0) {
+            doublePoints = false;
+        }
+    }
+
+    // Update game state
+    gameTime--;
+    if (gameTime <= 0) {
+        if (!gameOver) {
+            events |= EVENT_WIN;
+        }
+        gameOver = true;
+    }
+
+    // Increase game speed over time
+    gameSpeed += level->speedIncreaseAt(tick);
+    tick++;
+    animation.advance();
+}
+
+void RunnerWorld::moveObjects() {
+    ScopedTimer moveTimer(profiler, PHASE_MOVE);
+
+    playerPrevX = playerX;
+    playerPrevY = playerY;
+    storePreviousPositions(obstacles);
+    storePreviousPositions(collectables);
+    storePreviousPositions(powerups);
+
+    // Update player position
+    if (isJumping) {
+        playerY += jumpVelocity;
+        jumpVelocity -= level->gravity;
+        if (playerY <= GROUND_HEIGHT) {
+            playerY = GROUND_HEIGHT;
+            isJumping = false;
+            jumpVelocity = 0;
+        }
+    }
+
+    // Move objects; anything that scrolls off screen is recycled
+    distance += gameSpeed;
+    scrollPool(obstacles, gameSpeed, -OBSTACLE_WIDTH, hits);
+    scrollPool(collectables, gameSpeed, -COLLECTABLE_SIZE, hits);
+    scrollPool(powerups, gameSpeed, -POWERUP_SIZE, hits);
+
+    if (coinMagnet) {
+        attractCollectables();
+    }
+}
+
+void RunnerWorld::attractCollectables() {
+    float* x = collectables.x.data();
+    float* y = collectables.y.data();
+    int inRange = findAheadWithin(x, y, collectables.size(), playerX, playerY, level->magnetRadius, hits.data());
+    float pull = level->magnetPullPerTick; // Fraction of the remaining distance closed per tick
+    for (int i = 0; i < inRange; i++) {
+        int index = hits[i];
+        x[index] += (playerX - x[index]) * pull;
+        y[index] += (playerY - y[index]) * pull;
+    }
+}
+
+void RunnerWorld::checkCollisions() {
+    ScopedTimer collideTimer(profiler, PHASE_COLLIDE);
+
+    // Every pool is swept against the player box in one vector pass. Objects
+    // move every tick, so a broadphase would have to be rebuilt every tick
+    // too; BM_CollideSweep vs BM_CollideGrid has the sweep ahead at every
+    // pool size from 10 to a million.
+    Box player = playerBox();
+
+    if (findHits(obstacles, OBSTACLE_SHAPE, player, hits) > 0) {
+        Box hit = objectBox(OBSTACLE_SHAPE, obstacles.x[hits[0]], obstacles.y[hits[0]], obstacles.isHighObstacle[hits[0]]);
+        health--;
+        events |= EVENT_HIT;
+        if (health <= 0) {
+            gameOver = true;
+            events |= EVENT_LOSE;
+        }
+        playerX = hit.minX - PLAYER_WIDTH/2.0f - 5; // Move player back slightly
+        obstacles.kill(hits[0]); // Only one collision per step
+        player = playerBox();
+    }
+
+    for (int i = findHits(collectables, COLLECTABLE_SHAPE, player, hits) - 1; i >= 0; i--) {
+        score += (doublePoints ? 2 : 1);
+        events |= EVENT_COLLECT;
+        collectables.kill(hits[i]);
+    }
+
+    for (int i = findHits(powerups, POWERUP_SHAPE, player, hits) - 1; i >= 0; i--) {
+        int index = hits[i];
+        if (powerups.isHighObstacle[index]) { // Using isHighObstacle to differentiate between powerup types
+            coinMagnet = true;
+            coinMagnetTime = level->powerupDuration;
+        } else {
+            doublePoints = true;
+            doublePointsTime = level->powerupDuration;
+        }
+        events |= EVENT_POWERUP;
+        powerups.kill(index);
+    }
+}
+
+void RunnerWorld::spawnObjects() {
+    ScopedTimer spawnTimer(profiler, PHASE_SPAWN);
+
+    // Everything the schedule has placed up to here enters at the right
+    // edge, less however far it has already scrolled
+    SpawnEvent event;
+    while (spawns.next(distance, event)) {
+        float x = float(WINDOW_WIDTH - (distance - event.distance));
+        if (event.kind == SPAWN_OBSTACLE) {
+            obstacles.spawn({x, event.y, x, event.y, 0, event.variant});
+        } else if (event.kind == SPAWN_COLLECTABLE) {
+            collectables.spawn({x, event.y, x, event.y, 0, false});
+        } else {
+            uint8_t phase = uint8_t(tick % BOB_PHASES);
+            powerups.spawn({x, event.y, x, event.y, phase, event.variant});
+        }
+    }
+}
+
+void RunnerWorld::reset() {
+    playerX = 100;
+    playerY = GROUND_HEIGHT;
+    playerPrevX = playerX;
+    playerPrevY = playerY;
+    isJumping = false;
+    isDucking = false;
+    jumpVelocity = 0;
+    jumpBuffer = 0;
+    score = 0;
+    health = level->maxHealth;
+    gameTime = level->duration;
+    gameSpeed = level->initialSpeed;
+    gameOver = false;
+    coinMagnet = false;
+    coinMagnetTime = 0;
+    doublePoints = false;
+    doublePointsTime = 0;
+    tick = 0;
+    events = 0;
+    animation.reset();
+    distance = 0;
+    spawns.reset(*level, seed);
+    obstacles.clear();
+    collectables.clear();
+    powerups.clear();
+}
+
+// FNV-1a over the raw bytes of each field
+static void hashBytes(uint64_t& hash, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+}
+
+template <typename T>
+static void hashValue(uint64_t& hash, const T& value) {
+    hashBytes(hash, &value, sizeof(value));
+}
+
+static void hashPool(uint64_t& hash, const EntityPool& pool) {
+    hashValue(hash, pool.size());
+    for (int i = 0; i < pool.size(); i++) {
+        hashValue(hash, pool.x[i]);
+        hashValue(hash, pool.y[i]);
+        hashValue(hash, bool(pool.isHighObstacle[i]));
+    }
+}
+
+uint64_t RunnerWorld::checksum() const {
+    uint64_t hash = 14695981039346656037ULL;
+    hashValue(hash, tick);
+    hashValue(hash, playerX);
+    hashValue(hash, playerY);
+    hashValue(hash, isJumping);
+    hashValue(hash, isDucking);
+    hashValue(hash, jumpVelocity);
+    hashValue(hash, jumpBuffer);
+    hashValue(hash, score);
+    hashValue(hash, health);
+    hashValue(hash, gameTime);
+    hashValue(hash, gameSpeed);
+    hashValue(hash, distance);
+    hashValue(hash, coinMagnetTime);
+    hashValue(hash, doublePointsTime);
+    hashPool(hash, obstacles);
+    hashPool(hash, collectables);
+    hashPool(hash, powerups);
+    return hash;
+}
@@ -0,0 +1,144 @@
+#ifndef RUNNER_WORLD_H
+#define RUNNER_WORLD_H
+
+#include "EntityPool.h"
+#include "Hitbox.h"
+#include "Animation.h"
+#include "LevelConfig.h"
+#include "SpawnSchedule.h"
+#include "Profiler.h"
+#include <cstdint>
+#include <vector>
+
+// Game constants
+const int WINDOW_WIDTH = 800;
+const int WINDOW_HEIGHT = 600;
+const int PLAYER_WIDTH = 30;
+const int PLAYER_HEIGHT = 50;
+const int PLAYER_DUCK_HEIGHT = 25;
+const int OBSTACLE_WIDTH = 30;
+const int OBSTACLE_HEIGHT = 55;
+const int COLLECTABLE_SIZE = 20;
+const int POWERUP_SIZE = 25;
+const int GROUND_HEIGHT = 50;
+const int BOUNDARY_HEIGHT = 30;
+const int POOL_CAPACITY = 1024; // Per object type; spawns beyond this are dropped
+const int JUMP_BUFFER_TICKS = 6; // A jump pressed up to this early before landing still fires
+
+// Drawn extents that are not plain constants above. The meshes in
+// RunnerScene.cpp and the hitboxes below both use these, so what you see is
+// what you collide with.
+const int PLAYER_HEAD_HEIGHT = PLAYER_WIDTH/2;
+const float LOW_OBSTACLE_HEIGHT = 70;
+const float HIGH_OBSTACLE_HEIGHT = OBSTACLE_HEIGHT * 3.0f;
+const float OBSTACLE_TOP_RADIUS = OBSTACLE_WIDTH/8.0f;
+
+// Hitboxes relative to an object's (x, y)
+
+// Cactus: body plus arms, up to the top of the flower
+const ObjectShape OBSTACLE_SHAPE = {-OBSTACLE_WIDTH/2.0f, OBSTACLE_WIDTH/2.0f,
+                                    0, LOW_OBSTACLE_HEIGHT + OBSTACLE_TOP_RADIUS, HIGH_OBSTACLE_HEIGHT + OBSTACLE_TOP_RADIUS};
+// Coin circle, drawn centered half a size above y
+const ObjectShape COLLECTABLE_SHAPE = {-COLLECTABLE_SIZE/2.0f, COLLECTABLE_SIZE/2.0f, 0, COLLECTABLE_SIZE, COLLECTABLE_SIZE};
+// Magnet and diamond both span one POWERUP_SIZE around their center
+const ObjectShape POWERUP_SHAPE = {-POWERUP_SIZE, POWERUP_SIZE, -POWERUP_SIZE, POWERUP_SIZE, POWERUP_SIZE};
+
+// What happened on a tick, for sounds and effects (RunnerWorld::events)
+enum WorldEvent {
+    EVENT_JUMP = 1,
+    EVENT_HIT = 2,
+    EVENT_COLLECT = 4,
+    EVENT_POWERUP = 8,
+    EVENT_WIN = 16,   // Time ran out with health left
+    EVENT_LOSE = 32
+};
+
+// Player controls for one tick. jump is an edge (pressed this tick), duck a
+// level (held).
+struct RunnerInput {
+    bool jump = false;
+    bool duck = false;
+
+    uint8_t bits() const { return uint8_t((jump ? 1 : 0) | (duck ? 2 : 0)); }
+    static RunnerInput fromBits(uint8_t bits) {
+        RunnerInput input;
+        input.jump = (bits & 1) != 0;
+        input.duck = (bits & 2) != 0;
+        return input;
+    }
+};
+
+// All state of a single run. Nothing in here touches GL or GLUT, so a world
+// can be stepped by the windowed game, a headless driver or a benchmark alike.
+struct RunnerWorld {
+    float playerX = 100;
+    float playerY = GROUND_HEIGHT;
+    float playerPrevX = 100;
+    float playerPrevY = GROUND_HEIGHT;
+    bool isJumping = false;
+    bool isDucking = false;
+    float jumpVelocity = 0;
+    int jumpBuffer = 0; // Ticks a jump pressed in the air is still waiting
+    int score = 0;
+    int health = MAX_HEALTH;
+    int gameTime = GAME_DURATION;
+    float gameSpeed = INITIAL_GAME_SPEED;
+    bool gameOver = false;
+    bool coinMagnet = false;
+    int coinMagnetTime = 0;
+    bool doublePoints = false;
+    int doublePointsTime = 0;
+    long long tick = 0;
+    AnimationClock animation;
+
+    // WorldEvent bits, added to by applyInput() and step(); whoever reacts to
+    // them clears them. Not part of the gameplay state.
+    uint32_t events = 0;
+
+    // Tuning for this run; must outlive the world. Starting health, time and
+    // speed are taken from it at reset(), everything else every tick.
+    const LevelConfig* level = &defaultLevel();
+
+    // Every random decision is made by spawns, which reset() restarts from
+    // seed, so a seed plus the per-tick inputs reproduce a run exactly.
+    uint64_t seed = 0;
+    SpawnSchedule spawns;
+    double distance = 0; // Scrolled so far; spawns are scheduled against it
+
+    EntityPool obstacles;
+    EntityPool collectables;
+    EntityPool powerups;
+
+    std::vector<int> hits; // Scratch list of indices to remove, one slot per pool entry
+
+    // Receives per-phase step timings when set
+    Profiler* profiler = nullptr;
+
+    explicit RunnerWorld(int poolCapacity = POOL_CAPACITY);
+
+    // Body and head, at the current duck state
+    Box playerBox() const;
+
+    // Starts a jump if the player is standing on the ground; false if not.
+    bool jump();
+    void setDucking(bool ducking);
+    void applyInput(const RunnerInput& input);
+
+    // Advances the simulation by one fixed tick.
+    void step();
+    // The timed phases of step()
+    void moveObjects();
+    void spawnObjects();
+    void checkCollisions();
+    // Part of moveObjects() while the coin magnet is on, timed with it
+    void attractCollectables();
+
+    // Starts a new run from seed.
+    void reset();
+
+    // Hash of the gameplay state; equal checksums after the same number of
+    // ticks mean a replay reproduced the run.
+    uint64_t checksum() const;
+};
+
+#endif
@@ -0,0 +1,214 @@
+#include "SimdKernels.h"
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define RUNNER_SSE2 1
+#endif
+
+// Overlap of shape-at-(x, y) with target, rearranged so each object costs four
+// compares against per-call thresholds:
+//   x + minDX < target.maxX  <=>  x < xHigh
+//   x + maxDX > target.minX  <=>  x > xLow
+//   y + minDY < target.maxY  <=>  y < yHigh
+//   y + maxDY > target.minY  <=>  y > yLow (yLowTall for high objects)
+struct OverlapBounds {
+    float xLow, xHigh, yLow, yLowTall, yHigh;
+};
+
+static OverlapBounds overlapBounds(const ObjectShape& shape, const Box& target) {
+    return {target.minX - shape.maxDX, target.maxX - shape.minDX,
+            target.minY - shape.maxDY, target.minY - shape.maxDYHigh, target.maxY - shape.minDY};
+}
+
+static int scrollAndCullScalar(float* x, int begin, int count, float speed, float limit, int* out, int found) {
+    for (int i = begin; i < count; i++) {
+        x[i] -= speed;
+        if (x[i] < limit) out[found++] = i;
+    }
+    return found;
+}
+
+static int findOverlapsScalar(const float* x, const float* y, const uint8_t* high, int begin, int count,
+                              const OverlapBounds& b, int* out, int found) {
+    for (int i = begin; i < count; i++) {
+        float yLow = high[i] ? b.yLowTall : b.yLow;
+        if (x[i] > b.xLow && x[i] < b.xHigh && y[i] < b.yHigh && y[i] > yLow) out[found++] = i;
+    }
+    return found;
+}
+
+static int findAheadWithinScalar(const float* x, const float* y, int begin, int count,
+                                 float centerX, float centerY, float radiusSquared, int* out, int found) {
+    for (int i = begin; i < count; i++) {
+        float dx = centerX - x[i];
+        float dy = centerY - y[i];
+        if (x[i] > centerX && dx * dx + dy * dy < radiusSquared) out[found++] = i;
+    }
+    return found;
+}
+
+#if defined(__AVX2__) || defined(RUNNER_SSE2)
+
+// Appends base + the index of every set bit in mask.
+static int emitBits(unsigned mask, int base, int* out, int found) {
+    while (mask) {
+        out[found++] = base + __builtin_ctz(mask);
+        mask &= mask - 1;
+    }
+    return found;
+}
+
+#endif
+
+#if defined(__AVX2__)
+
+const char* simdLevel() {
+    return "avx2";
+}
+
+int scrollAndCull(float* x, int count, float speed, float limit, int* out) {
+    __m256 vSpeed = _mm256_set1_ps(speed);
+    __m256 vLimit = _mm256_set1_ps(limit);
+    int found = 0;
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 moved = _mm256_sub_ps(_mm256_loadu_ps(x + i), vSpeed);
+        _mm256_storeu_ps(x + i, moved);
+        unsigned mask = unsigned(_mm256_movemask_ps(_mm256_cmp_ps(moved, vLimit, _CMP_LT_OQ)));
+        found = emitBits(mask, i, out, found);
+    }
+    return scrollAndCullScalar(x, i, count, speed, limit, out, found);
+}
+
+int findOverlaps(const float* x, const float* y, const uint8_t* high, int count,
+                 const ObjectShape& shape, const Box& target, int* out) {
+    OverlapBounds b = overlapBounds(shape, target);
+    __m256 xLow = _mm256_set1_ps(b.xLow);
+    __m256 xHigh = _mm256_set1_ps(b.xHigh);
+    __m256 yLow = _mm256_set1_ps(b.yLow);
+    __m256 yLowTall = _mm256_set1_ps(b.yLowTall);
+    __m256 yHigh = _mm256_set1_ps(b.yHigh);
+    __m256i zero = _mm256_setzero_si256();
+    int found = 0;
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 vx = _mm256_loadu_ps(x + i);
+        __m256 vy = _mm256_loadu_ps(y + i);
+        __m256i flags = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(high + i)));
+        __m256 tall = _mm256_castsi256_ps(_mm256_xor_si256(_mm256_cmpeq_epi32(flags, zero), _mm256_set1_epi32(-1)));
+        __m256 vyLow = _mm256_blendv_ps(yLow, yLowTall, tall);
+        __m256 hit = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(vx, xLow, _CMP_GT_OQ), _mm256_cmp_ps(vx, xHigh, _CMP_LT_OQ)),
+                                   _mm256_and_ps(_mm256_cmp_ps(vy, yHigh, _CMP_LT_OQ), _mm256_cmp_ps(vy, vyLow, _CMP_GT_OQ)));
+        found = emitBits(unsigned(_mm256_movemask_ps(hit)), i, out, found);
+    }
+    return findOverlapsScalar(x, y, high, i, count, b, out, found);
+}
+
+int findAheadWithin(const float* x, const float* y, int count, float centerX, float centerY, float radius, int* out) {
+    float radiusSquared = radius * radius;
+    __m256 cx = _mm256_set1_ps(centerX);
+    __m256 cy = _mm256_set1_ps(centerY);
+    __m256 r2 = _mm256_set1_ps(radiusSquared);
+    int found = 0;
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 vx = _mm256_loadu_ps(x + i);
+        __m256 dx = _mm256_sub_ps(cx, vx);
+        __m256 dy = _mm256_sub_ps(cy, _mm256_loadu_ps(y + i));
+        // Separate multiply and add (no FMA) to round exactly like the scalar path
+        __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        __m256 hit = _mm256_and_ps(_mm256_cmp_ps(vx, cx, _CMP_GT_OQ), _mm256_cmp_ps(d2, r2, _CMP_LT_OQ));
+        found = emitBits(unsigned(_mm256_movemask_ps(hit)), i, out, found);
+    }
+    return findAheadWithinScalar(x, y, i, count, centerX, centerY, radiusSquared, out, found);
+}
+
+#elif defined(RUNNER_SSE2)
+
+const char* simdLevel() {
+    return "sse2";
+}
+
+int scrollAndCull(float* x, int count, float speed, float limit, int* out) {
+    __m128 vSpeed = _mm_set1_ps(speed);
+    __m128 vLimit = _mm_set1_ps(limit);
+    int found = 0;
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 moved = _mm_sub_ps(_mm_loadu_ps(x + i), vSpeed);
+        _mm_storeu_ps(x + i, moved);
+        found = emitBits(unsigned(_mm_movemask_ps(_mm_cmplt_ps(moved, vLimit))), i, out, found);
+    }
+    return scrollAndCullScalar(x, i, count, speed, limit, out, found);
+}
+
+int findOverlaps(const float* x, const float* y, const uint8_t* high, int count,
+                 const ObjectShape& shape, const Box& target, int* out) {
+    OverlapBounds b = overlapBounds(shape, target);
+    __m128 xLow = _mm_set1_ps(b.xLow);
+    __m128 xHigh = _mm_set1_ps(b.xHigh);
+    __m128 yLow = _mm_set1_ps(b.yLow);
+    __m128 yLowTall = _mm_set1_ps(b.yLowTall);
+    __m128 yHigh = _mm_set1_ps(b.yHigh);
+    __m128i zero = _mm_setzero_si128();
+    int found = 0;
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 vx = _mm_loadu_ps(x + i);
+        __m128 vy = _mm_loadu_ps(y + i);
+        // Widen four flag bytes to four 32-bit lanes; SSE2 has no blend, so
+        // select the y threshold with and/andnot.
+        int packed;
+        memcpy(&packed, high + i, 4);
+        __m128i bytes = _mm_cvtsi32_si128(packed);
+        __m128i flags = _mm_unpacklo_epi16(_mm_unpacklo_epi8(bytes, zero), zero);
+        __m128 flat = _mm_castsi128_ps(_mm_cmpeq_epi32(flags, zero));
+        __m128 vyLow = _mm_or_ps(_mm_and_ps(flat, yLow), _mm_andnot_ps(flat, yLowTall));
+        __m128 hit = _mm_and_ps(_mm_and_ps(_mm_cmpgt_ps(vx, xLow), _mm_cmplt_ps(vx, xHigh)),
+                                _mm_and_ps(_mm_cmplt_ps(vy, yHigh), _mm_cmpgt_ps(vy, vyLow)));
+        found = emitBits(unsigned(_mm_movemask_ps(hit)), i, out, found);
+    }
+    return findOverlapsScalar(x, y, high, i, count, b, out, found);
+}
+
+int findAheadWithin(const float* x, const float* y, int count, float centerX, float centerY, float radius, int* out) {
+    float radiusSquared = radius * radius;
+    __m128 cx = _mm_set1_ps(centerX);
+    __m128 cy = _mm_set1_ps(centerY);
+    __m128 r2 = _mm_set1_ps(radiusSquared);
+    int found = 0;
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 vx = _mm_loadu_ps(x + i);
+        __m128 dx = _mm_sub_ps(cx, vx);
+        __m128 dy = _mm_sub_ps(cy, _mm_loadu_ps(y + i));
+        __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        __m128 hit = _mm_and_ps(_mm_cmpgt_ps(vx, cx), _mm_cmplt_ps(d2, r2));
+        found = emitBits(unsigned(_mm_movemask_ps(hit)), i, out, found);
+    }
+    return findAheadWithinScalar(x, y, i, count, centerX, centerY, radiusSquared, out, found);
+}
+
+#else
+
+const char* simdLevel() {
+    return "scalar";
+}
+
+int scrollAndCull(float* x, int count, float speed, float limit, int* out) {
+    return scrollAndCullScalar(x, 0, count, speed, limit, out, 0);
+}
+
+int findOverlaps(const float* x, const float* y, const uint8_t* high, int count,
+                 const ObjectShape& shape, const Box& target, int* out) {
+    return findOverlapsScalar(x, y, high, 0, count, overlapBounds(shape, target), out, 0);
+}
+
+int findAheadWithin(const float* x, const float* y, int count, float centerX, float centerY, float radius, int* out) {
+    return findAheadWithinScalar(x, y, 0, count, centerX, centerY, radius * radius, out, 0);
+}
+
+#endif
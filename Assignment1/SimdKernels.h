@@ -0,0 +1,28 @@
+#ifndef SIMD_KERNELS_H
+#define SIMD_KERNELS_H
+
+#include "Hitbox.h"
+#include <cstdint>
+
+// Column kernels for the entity pools. Built with AVX2 when the compiler
+// targets it (e.g. RUNNER_NATIVE), otherwise SSE2 on x86-64, otherwise plain
+// scalar code. All paths compare with the same precomputed thresholds, so
+// they give bit-identical results and replays stay portable.
+
+// "avx2", "sse2" or "scalar"
+const char* simdLevel();
+
+// x[i] -= speed for every object, then writes the indices (ascending) of
+// objects now left of limit to out. Returns how many were written.
+int scrollAndCull(float* x, int count, float speed, float limit, int* out);
+
+// Writes the indices (ascending) of objects whose shape at (x[i], y[i])
+// overlaps target to out. Returns how many were written.
+int findOverlaps(const float* x, const float* y, const uint8_t* high, int count,
+                 const ObjectShape& shape, const Box& target, int* out);
+
+// Writes the indices (ascending) of objects right of centerX and closer than
+// radius to (centerX, centerY) to out. Returns how many were written.
+int findAheadWithin(const float* x, const float* y, int count, float centerX, float centerY, float radius, int* out);
+
+#endif
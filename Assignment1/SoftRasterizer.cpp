@@ -0,0 +1,322 @@
+#include "SoftRasterizer.h"
+#include "ByteIO.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+static inline uint32_t toByte(float value) {
+    return uint32_t(std::max(0.0f, std::min(value, 1.0f)) * 255.0f + 0.5f);
+}
+
+static inline uint32_t packColor(float r, float g, float b) {
+    return toByte(r) | toByte(g) << 8 | toByte(b) << 16;
+}
+
+// GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA
+static inline void blend(uint32_t& dst, float r, float g, float b, float a) {
+    if (a >= 1.0f) {
+        dst = packColor(r, g, b);
+        return;
+    }
+    if (a <= 0.0f) return;
+    float keep = (1.0f - a) / 255.0f;
+    dst = packColor(r * a + float(dst & 0xff) * keep,
+                    g * a + float((dst >> 8) & 0xff) * keep,
+                    b * a + float((dst >> 16) & 0xff) * keep);
+}
+
+void Framebuffer::resize(int w, int h) {
+    width = w;
+    height = h;
+    pixels.assign(size_t(w) * h, 0);
+}
+
+void Framebuffer::clear(float r, float g, float b) {
+    std::fill(pixels.begin(), pixels.end(), packColor(r, g, b));
+}
+
+uint64_t Framebuffer::hash() const {
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (uint32_t pixel : pixels) {
+        for (int i = 0; i < 3; i++) {
+            h = (h ^ ((pixel >> (8 * i)) & 0xff)) * 0x100000001b3ull;
+        }
+    }
+    return h;
+}
+
+bool Framebuffer::writePpm(const char* path) const {
+    char header[64];
+    int headerLength = snprintf(header, sizeof(header), "P6\n%d %d\n255\n", width, height);
+    std::vector<uint8_t> data(header, header + headerLength);
+    data.reserve(data.size() + pixels.size() * 3);
+    for (int y = height - 1; y >= 0; y--) {
+        for (int x = 0; x < width; x++) {
+            uint32_t p = pixel(x, y);
+            data.push_back(uint8_t(p));
+            data.push_back(uint8_t(p >> 8));
+            data.push_back(uint8_t(p >> 16));
+        }
+    }
+    return writeFile(path, data);
+}
+
+SoftRasterizer::SoftRasterizer(int threads) : pool(threads) {}
+
+void SoftRasterizer::begin(Framebuffer& frame, float viewWidth, float viewHeight) {
+    target = &frame;
+    scaleX = frame.width / viewWidth;
+    scaleY = frame.height / viewHeight;
+    tilesX = (frame.width + TILE_SIZE - 1) / TILE_SIZE;
+    tilesY = (frame.height + TILE_SIZE - 1) / TILE_SIZE;
+    if (int(tileLists.size()) != tilesX * tilesY) {
+        tileLists.resize(size_t(tilesX) * tilesY);
+    }
+    for (std::vector<uint32_t>& list : tileLists) {
+        list.clear();
+    }
+    primitives.clear();
+}
+
+void SoftRasterizer::add(const DrawBatch& batch, float dx, float dy) {
+    auto toPixels = [&](const Vertex& v) {
+        Vertex p = v;
+        p.x = (v.x + dx) * scaleX;
+        p.y = (v.y + dy) * scaleY;
+        return p;
+    };
+
+    Primitive primitive;
+    primitive.kind = PRIMITIVE_TRIANGLE;
+    primitive.size = 1;
+    for (size_t i = 0; i + 2 < batch.triangles.size(); i += 3) {
+        for (int k = 0; k < 3; k++) {
+            primitive.v[k] = toPixels(batch.triangles[i + k]);
+        }
+        const Vertex* v = primitive.v;
+        bin(primitive, std::min({v[0].x, v[1].x, v[2].x}), std::min({v[0].y, v[1].y, v[2].y}),
+            std::max({v[0].x, v[1].x, v[2].x}), std::max({v[0].y, v[1].y, v[2].y}));
+    }
+
+    primitive.kind = PRIMITIVE_LINE;
+    const std::vector<Vertex>* lineLists[2] = {&batch.lines, &batch.wideLines};
+    for (int width = 1; width <= 2; width++) {
+        const std::vector<Vertex>& lines = *lineLists[width - 1];
+        primitive.size = uint8_t(width);
+        for (size_t i = 0; i + 1 < lines.size(); i += 2) {
+            primitive.v[0] = toPixels(lines[i]);
+            primitive.v[1] = toPixels(lines[i + 1]);
+            const Vertex* v = primitive.v;
+            bin(primitive, std::min(v[0].x, v[1].x) - width, std::min(v[0].y, v[1].y) - width,
+                std::max(v[0].x, v[1].x) + width, std::max(v[0].y, v[1].y) + width);
+        }
+    }
+
+    primitive.kind = PRIMITIVE_POINT;
+    primitive.size = 3;
+    for (const Vertex& point : batch.points) {
+        primitive.v[0] = toPixels(point);
+        const Vertex& v = primitive.v[0];
+        bin(primitive, v.x - 2, v.y - 2, v.x + 2, v.y + 2);
+    }
+}
+
+// Records primitive in every tile its pixel-space bounds overlap.
+void SoftRasterizer::bin(const Primitive& primitive, float minX, float minY, float maxX, float maxY) {
+    if (maxX < 0 || maxY < 0 || minX >= target->width || minY >= target->height) return;
+    int tx0 = std::max(0, int(minX) / TILE_SIZE);
+    int ty0 = std::max(0, int(minY) / TILE_SIZE);
+    int tx1 = std::min(tilesX - 1, int(maxX) / TILE_SIZE);
+    int ty1 = std::min(tilesY - 1, int(maxY) / TILE_SIZE);
+
+    uint32_t index = uint32_t(primitives.size());
+    primitives.push_back(primitive);
+    for (int ty = ty0; ty <= ty1; ty++) {
+        for (int tx = tx0; tx <= tx1; tx++) {
+            tileLists[size_t(ty) * tilesX + tx].push_back(index);
+        }
+    }
+}
+
+void SoftRasterizer::finish() {
+    pool.run(tilesX * tilesY, shadeTileTask, this);
+    target = nullptr;
+}
+
+void SoftRasterizer::shadeTileTask(void* context, int tile) {
+    static_cast<SoftRasterizer*>(context)->shadeTile(tile);
+}
+
+// Pixel rectangle [x0, x1) x [y0, y1) that one tile owns
+struct TileRect {
+    int x0, y0, x1, y1;
+};
+
+// Fills pixels whose centers lie inside the triangle, with the top-left
+// rule deciding centers exactly on a shared edge so neighbours never both
+// draw (and double-blend) them. Each edge value is computed from scratch
+// per pixel, so the result does not depend on how the screen is tiled.
+static void shadeTriangle(const Vertex* v, Framebuffer& frame, const TileRect& rect) {
+    const Vertex* a = &v[0];
+    const Vertex* b = &v[1];
+    const Vertex* c = &v[2];
+    float area = (b->x - a->x) * (c->y - a->y) - (b->y - a->y) * (c->x - a->x);
+    if (area == 0) return;
+    if (area < 0) {
+        std::swap(b, c);
+        area = -area;
+    }
+
+    const Vertex* from[3] = {b, c, a};
+    const Vertex* to[3] = {c, a, b};
+    float ex[3], ey[3];
+    bool topLeft[3];
+    for (int e = 0; e < 3; e++) {
+        ex[e] = to[e]->x - from[e]->x;
+        ey[e] = to[e]->y - from[e]->y;
+        topLeft[e] = ey[e] < 0 || (ey[e] == 0 && ex[e] < 0);
+    }
+
+    float minX = std::min({a->x, b->x, c->x});
+    float maxX = std::max({a->x, b->x, c->x});
+    float minY = std::min({a->y, b->y, c->y});
+    float maxY = std::max({a->y, b->y, c->y});
+    int x0 = std::max(rect.x0, int(std::floor(minX)));
+    int x1 = std::min(rect.x1, int(std::ceil(maxX)) + 1);
+    int y0 = std::max(rect.y0, int(std::floor(minY)));
+    int y1 = std::min(rect.y1, int(std::ceil(maxY)) + 1);
+
+    // Most shapes are one opaque color, which needs no interpolation or
+    // blending per pixel
+    bool flat = a->r == b->r && a->r == c->r && a->g == b->g && a->g == c->g && a->b == b->b && a->b == c->b &&
+                a->a == b->a && a->a == c->a;
+    bool opaque = flat && a->a >= 1.0f;
+    uint32_t packed = packColor(a->r, a->g, a->b);
+
+    float inverseArea = 1.0f / area;
+    for (int y = y0; y < y1; y++) {
+        float py = y + 0.5f;
+        // w[e] = rowBase[e] - ey[e] * px is the weight of the vertex opposite
+        // edge e, times the area
+        float rowBase[3];
+        for (int e = 0; e < 3; e++) {
+            rowBase[e] = ex[e] * (py - from[e]->y) + ey[e] * from[e]->x;
+        }
+        // Narrow the row to where each edge can pass, give or take a pixel;
+        // the exact test below still decides every pixel
+        int spanBegin = x0, spanEnd = x1;
+        for (int e = 0; e < 3; e++) {
+            if (ey[e] == 0) {
+                if (rowBase[e] < 0) spanEnd = spanBegin;
+                continue;
+            }
+            float crossing = rowBase[e] / ey[e] - 0.5f;
+            if (crossing < float(x0) - 2 || crossing > float(x1) + 2) {
+                // Outside the row's range: the edge passes all of it or none
+                bool passes = (ey[e] < 0) == (crossing < float(x0));
+                if (!passes) spanEnd = spanBegin;
+            } else if (ey[e] < 0) {
+                spanBegin = std::max(spanBegin, int(std::floor(crossing)));
+            } else {
+                spanEnd = std::min(spanEnd, int(std::ceil(crossing)) + 1);
+            }
+        }
+
+        uint32_t* row = frame.pixels.data() + size_t(y) * frame.width;
+        for (int x = spanBegin; x < spanEnd; x++) {
+            float px = x + 0.5f;
+            float w0 = rowBase[0] - ey[0] * px;
+            float w1 = rowBase[1] - ey[1] * px;
+            float w2 = rowBase[2] - ey[2] * px;
+            bool inside = (w0 > 0 || (w0 == 0 && topLeft[0])) & (w1 > 0 || (w1 == 0 && topLeft[1])) &
+                          (w2 > 0 || (w2 == 0 && topLeft[2]));
+            if (!inside) continue;
+
+            if (opaque) {
+                row[x] = packed;
+            } else if (flat) {
+                blend(row[x], a->r, a->g, a->b, a->a);
+            } else {
+                float wa = w0 * inverseArea, wb = w1 * inverseArea, wc = w2 * inverseArea;
+                blend(row[x], a->r * wa + b->r * wb + c->r * wc, a->g * wa + b->g * wb + c->g * wc,
+                      a->b * wa + b->b * wb + c->b * wc, a->a * wa + b->a * wb + c->a * wc);
+            }
+        }
+    }
+}
+
+// Steps along the major axis one pixel center at a time, like an aliased GL
+// line, filling width pixels across the minor axis at each step.
+static void shadeLine(const Vertex* v, int width, Framebuffer& frame, const TileRect& rect) {
+    float dx = v[1].x - v[0].x;
+    float dy = v[1].y - v[0].y;
+    if (dx == 0 && dy == 0) return;
+    bool xMajor = std::fabs(dx) >= std::fabs(dy);
+
+    float major0 = xMajor ? v[0].x : v[0].y;
+    float major1 = xMajor ? v[1].x : v[1].y;
+    float minor0 = xMajor ? v[0].y : v[0].x;
+    float slope = xMajor ? dy / dx : dx / dy;
+    float length = major1 - major0;
+    int first = int(std::ceil(std::min(major0, major1) - 0.5f));
+    int last = int(std::ceil(std::max(major0, major1) - 0.5f)); // Exclusive
+    first = std::max(first, xMajor ? rect.x0 : rect.y0);
+    last = std::min(last, xMajor ? rect.x1 : rect.y1);
+    int minorLow = xMajor ? rect.y0 : rect.x0;
+    int minorHigh = xMajor ? rect.y1 : rect.x1;
+
+    for (int i = first; i < last; i++) {
+        float center = i + 0.5f;
+        float minor = minor0 + (center - major0) * slope;
+        int base = int(std::floor(minor - (width - 1) * 0.5f));
+        int from = std::max(base, minorLow);
+        int to = std::min(base + width, minorHigh);
+        if (from >= to) continue;
+
+        float t = (center - major0) / length;
+        float r = v[0].r + (v[1].r - v[0].r) * t;
+        float g = v[0].g + (v[1].g - v[0].g) * t;
+        float b = v[0].b + (v[1].b - v[0].b) * t;
+        float a = v[0].a + (v[1].a - v[0].a) * t;
+        for (int j = from; j < to; j++) {
+            int x = xMajor ? i : j;
+            int y = xMajor ? j : i;
+            blend(frame.pixels[size_t(y) * frame.width + x], r, g, b, a);
+        }
+    }
+}
+
+// Square of size pixels around the point, as GL draws aliased points
+static void shadePoint(const Vertex& v, int size, Framebuffer& frame, const TileRect& rect) {
+    int left = int(std::floor(v.x - (size - 1) * 0.5f));
+    int bottom = int(std::floor(v.y - (size - 1) * 0.5f));
+    int x0 = std::max(left, rect.x0), x1 = std::min(left + size, rect.x1);
+    int y0 = std::max(bottom, rect.y0), y1 = std::min(bottom + size, rect.y1);
+    for (int y = y0; y < y1; y++) {
+        for (int x = x0; x < x1; x++) {
+            blend(frame.pixels[size_t(y) * frame.width + x], v.r, v.g, v.b, v.a);
+        }
+    }
+}
+
+void SoftRasterizer::shadeTile(int tile) {
+    int tx = tile % tilesX;
+    int ty = tile / tilesX;
+    TileRect rect = {tx * TILE_SIZE, ty * TILE_SIZE, std::min((tx + 1) * TILE_SIZE, target->width),
+                     std::min((ty + 1) * TILE_SIZE, target->height)};
+
+    for (uint32_t index : tileLists[tile]) {
+        const Primitive& primitive = primitives[index];
+        switch (primitive.kind) {
+        case PRIMITIVE_TRIANGLE:
+            shadeTriangle(primitive.v, *target, rect);
+            break;
+        case PRIMITIVE_LINE:
+            shadeLine(primitive.v, primitive.size, *target, rect);
+            break;
+        case PRIMITIVE_POINT:
+            shadePoint(primitive.v[0], primitive.size, *target, rect);
+            break;
+        }
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef SOFT_RASTERIZER_H
+#define SOFT_RASTERIZER_H
+
+#include "DrawBatch.h"
+#include "ThreadPool.h"
+#include <cstdint>
+#include <vector>
+
+// RGB image in memory, one 0x00BBGGRR word per pixel. Rows run bottom to top,
+// as in a GL framebuffer.
+struct Framebuffer {
+    int width = 0;
+    int height = 0;
+    std::vector<uint32_t> pixels;
+
+    void resize(int width, int height);
+    void clear(float r, float g, float b);
+    uint32_t pixel(int x, int y) const { return pixels[size_t(y) * width + x]; }
+    // FNV-1a over the pixels, for comparing frames against known-good ones
+    uint64_t hash() const;
+    // Binary PPM (P6), top row first; false on I/O error.
+    bool writePpm(const char* path) const;
+};
+
+// Draws DrawBatches into a Framebuffer on the CPU, following the same rules
+// as BatchRenderer: triangles, then 1 px lines, 2 px lines and 3 px points,
+// each blended by its vertex alpha, with colors interpolated across each
+// primitive. The target is cut into TILE_SIZE squares; primitives are binned
+// to the tiles they touch and tiles are shaded in parallel, each in
+// submission order, so the image is the same on any number of threads.
+//
+//   raster.begin(frame, WINDOW_WIDTH, WINDOW_HEIGHT);
+//   raster.add(meshes.ground, -scroll, 0);
+//   raster.add(sceneBatch);
+//   raster.finish();
+class SoftRasterizer {
+public:
+    static const int TILE_SIZE = 64;
+
+    // threads counts the calling thread; 0 means one per hardware thread.
+    explicit SoftRasterizer(int threads = 0);
+
+    int threadCount() const { return pool.threadCount(); }
+
+    // Starts a frame mapping [0, viewWidth] x [0, viewHeight] onto target,
+    // as gluOrtho2D does. Does not clear it.
+    void begin(Framebuffer& target, float viewWidth, float viewHeight);
+    // Queues batch shifted by (dx, dy). batch must stay unchanged until
+    // finish().
+    void add(const DrawBatch& batch, float dx = 0, float dy = 0);
+    // Draws everything queued since begin().
+    void finish();
+
+private:
+    enum PrimitiveKind : uint8_t { PRIMITIVE_TRIANGLE, PRIMITIVE_LINE, PRIMITIVE_POINT };
+
+    // Vertices already in pixel space
+    struct Primitive {
+        Vertex v[3];
+        PrimitiveKind kind;
+        uint8_t size; // Line width or point size in pixels
+    };
+
+    void bin(const Primitive& primitive, float minX, float minY, float maxX, float maxY);
+    void shadeTile(int tile);
+    static void shadeTileTask(void* context, int tile);
+
+    ThreadPool pool;
+    Framebuffer* target = nullptr;
+    float scaleX = 1, scaleY = 1;
+    int tilesX = 0, tilesY = 0;
+    std::vector<Primitive> primitives;
+    std::vector<std::vector<uint32_t>> tileLists; // Indices into primitives, per tile
+};
+
+#endif
@@ -0,0 +1,225 @@
+#include "SpawnSchedule.h"
+#include "RunnerWorld.h"
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Keeps a level with no speed from generating a chunk forever
+static const float MIN_GENERATOR_SPEED = 0.5f;
+// Furthest an obstacle reaches back over coins and powerups spawned before it
+static const float ITEM_REACH = std::max(POWERUP_SHAPE.maxDX, COLLECTABLE_SHAPE.maxDX) - OBSTACLE_SHAPE.minDX;
+// Room for a chunk of the default level several times over, so chunk
+// buffers are sized once and stepping does not allocate
+static const size_t CHUNK_RESERVE = 32;
+
+void SpawnGenerator::reset(const LevelConfig& level, uint64_t seed) {
+    this->level = &level;
+    rng.reseed(seed);
+    tick = 0;
+    speed = level.initialSpeed;
+    distance = 0;
+    chunkEnd = 0;
+    carried.clear();
+    jumpTicks = 2 * level.jumpVelocity / level.gravity;
+    lastObstacle = 0;
+    lastObstacleHigh = false;
+    anyObstacle = false;
+}
+
+double SpawnGenerator::generate(std::vector<SpawnEvent>& events) {
+    size_t chunkStart = events.size();
+    chunkEnd += SPAWN_CHUNK_LENGTH;
+    events.insert(events.end(), carried.begin(), carried.end());
+    carried.clear();
+    // Same order as RunnerWorld::step(): scroll, spawn, then speed up. Rolls
+    // run ITEM_REACH past the chunk, so an obstacle just beyond it can still
+    // remove the coins it would cover; whatever was spawned from the chunk
+    // end on waits for the next chunk.
+    while (distance < chunkEnd + ITEM_REACH) {
+        distance += std::max(speed, MIN_GENERATOR_SPEED);
+        rollTick(events, chunkStart);
+        speed += level->speedIncreaseAt(tick);
+        tick++;
+    }
+    size_t kept = events.size();
+    while (kept > chunkStart && events[kept - 1].distance >= chunkEnd) {
+        kept--;
+    }
+    carried.assign(events.begin() + kept, events.end());
+    events.resize(kept);
+    return chunkEnd;
+}
+
+// Whether an object of this shape spawned now would be clear of the last
+// obstacle's right side.
+bool SpawnGenerator::clearOfObstacle(const ObjectShape& shape) const {
+    return !anyObstacle || distance + shape.minDX >= lastObstacle + OBSTACLE_SHAPE.maxDX;
+}
+
+void SpawnGenerator::rollTick(std::vector<SpawnEvent>& events, size_t chunkStart) {
+    // Every roll is made whether or not its spawn is kept, so dropping one
+    // never shifts the dice for the rest of the run
+    if (level->obstacleSpawn.roll(rng)) {
+        bool isHigh = level->highObstacle.roll(rng);
+        // Low obstacles have to be jumped, and the player has to be down
+        // again before the next one
+        float gap = jumpTicks * speed + OBSTACLE_WIDTH + PLAYER_WIDTH;
+        bool fair = !anyObstacle || (isHigh && lastObstacleHigh) || distance - lastObstacle >= gap;
+        if (fair) {
+            // Coins and powerups this obstacle would cover go. Only those since
+            // the last obstacle and within ITEM_REACH can; a narrow coin that
+            // is clear does not mean a wider powerup before it is
+            size_t first = events.size();
+            while (first > chunkStart && events[first - 1].kind != SPAWN_OBSTACLE &&
+                   events[first - 1].distance + ITEM_REACH > distance) {
+                first--;
+            }
+            events.erase(std::remove_if(events.begin() + first, events.end(), [&](const SpawnEvent& item) {
+                const ObjectShape& shape = item.kind == SPAWN_POWERUP ? POWERUP_SHAPE : COLLECTABLE_SHAPE;
+                return item.distance + shape.maxDX > distance + OBSTACLE_SHAPE.minDX;
+            }), events.end());
+            float y = float(GROUND_HEIGHT + (isHigh ? OBSTACLE_HEIGHT : 0));
+            events.push_back({distance, y, SPAWN_OBSTACLE, isHigh});
+            lastObstacle = distance;
+            lastObstacleHigh = isHigh;
+            anyObstacle = true;
+        }
+    }
+    if (level->collectableSpawn.roll(rng)) {
+        float y = float(GROUND_HEIGHT + rng.below(level->spawnHeightRange));
+        if (clearOfObstacle(COLLECTABLE_SHAPE)) {
+            events.push_back({distance, y, SPAWN_COLLECTABLE, false});
+        }
+    }
+    if (level->powerupSpawn.roll(rng)) {
+        bool isCoinMagnet = level->coinMagnet.roll(rng);
+        float y = float(GROUND_HEIGHT + rng.below(level->spawnHeightRange));
+        if (clearOfObstacle(POWERUP_SHAPE)) {
+            events.push_back({distance, y, SPAWN_POWERUP, isCoinMagnet});
+        }
+    }
+}
+
+// Generates chunks into a ring buffer on its own thread. Everything here is
+// guarded by mutex; the generator itself is only touched by the thread.
+struct SpawnWorker {
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::vector<SpawnEvent> slots[SPAWN_RING_CHUNKS];
+    double slotEnd[SPAWN_RING_CHUNKS] = {};
+    uint64_t head = 0; // Chunks taken since the last reset
+    uint64_t tail = 0; // Chunks generated since the last reset
+    uint64_t epoch = 0; // Bumped by every reset; 0 until the first
+    const LevelConfig* level = nullptr;
+    uint64_t seed = 0;
+    bool stopping = false;
+    std::thread thread;
+
+    SpawnWorker() {
+        for (std::vector<SpawnEvent>& slot : slots) {
+            slot.reserve(CHUNK_RESERVE);
+        }
+        thread = std::thread(&SpawnWorker::run, this);
+    }
+
+    ~SpawnWorker() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        changed.notify_all();
+        thread.join();
+    }
+
+    void run() {
+        SpawnGenerator generator;
+        std::vector<SpawnEvent> scratch;
+        scratch.reserve(CHUNK_RESERVE);
+        uint64_t seenEpoch = 0;
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            changed.wait(lock, [&] {
+                return stopping || (epoch != 0 && (epoch != seenEpoch || tail - head < SPAWN_RING_CHUNKS));
+            });
+            if (stopping) return;
+            if (epoch != seenEpoch) {
+                seenEpoch = epoch;
+                generator.reset(*level, seed);
+            }
+
+            lock.unlock();
+            scratch.clear();
+            double end = generator.generate(scratch);
+            lock.lock();
+
+            // A reset while generating makes this chunk stale; the next pass
+            // starts over from the new seed
+            if (epoch != seenEpoch) continue;
+            size_t slot = size_t(tail % SPAWN_RING_CHUNKS);
+            slots[slot].swap(scratch);
+            slotEnd[slot] = end;
+            tail++;
+            changed.notify_all();
+        }
+    }
+};
+
+SpawnSchedule::SpawnSchedule() {
+    current.reserve(CHUNK_RESERVE);
+}
+
+SpawnSchedule::~SpawnSchedule() = default;
+SpawnSchedule::SpawnSchedule(SpawnSchedule&&) = default;
+SpawnSchedule& SpawnSchedule::operator=(SpawnSchedule&&) = default;
+
+void SpawnSchedule::reset(const LevelConfig& level, uint64_t seed) {
+    this->level = &level;
+    this->seed = seed;
+    current.clear();
+    cursor = 0;
+    currentEnd = 0;
+    if (worker) {
+        {
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            worker->level = &level;
+            worker->seed = seed;
+            worker->head = 0;
+            worker->tail = 0;
+            worker->epoch++;
+        }
+        worker->changed.notify_all();
+    } else {
+        generator.reset(level, seed);
+    }
+}
+
+void SpawnSchedule::startWorker() {
+    if (!worker) {
+        worker.reset(new SpawnWorker);
+        if (level) {
+            reset(*level, seed);
+        }
+    }
+}
+
+void SpawnSchedule::takeChunk() {
+    current.clear();
+    cursor = 0;
+    if (!worker) {
+        currentEnd = generator.generate(current);
+        return;
+    }
+
+    // Normally the worker is chunks ahead and this never waits; right after
+    // a reset it waits for the first one
+    {
+        std::unique_lock<std::mutex> lock(worker->mutex);
+        worker->changed.wait(lock, [&] { return worker->tail > worker->head; });
+        size_t slot = size_t(worker->head % SPAWN_RING_CHUNKS);
+        current.swap(worker->slots[slot]);
+        currentEnd = worker->slotEnd[slot];
+        worker->head++;
+    }
+    worker->changed.notify_all();
+}
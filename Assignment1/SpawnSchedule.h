@@ -0,0 +1,106 @@
+#ifndef SPAWN_SCHEDULE_H
+#define SPAWN_SCHEDULE_H
+
+#include "Hitbox.h"
+#include "LevelConfig.h"
+#include "Rng.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+enum SpawnKind : uint8_t {
+    SPAWN_OBSTACLE,
+    SPAWN_COLLECTABLE,
+    SPAWN_POWERUP
+};
+
+// One object to spawn at the right edge once the world has scrolled
+// distance pixels.
+struct SpawnEvent {
+    double distance;
+    float y;
+    SpawnKind kind;
+    bool variant; // High obstacle, or coin magnet rather than double points
+};
+
+// Distance covered by one generated chunk: a screen width
+const int SPAWN_CHUNK_LENGTH = 800;
+// Chunks a background worker keeps generated ahead of the player
+const int SPAWN_RING_CHUNKS = 4;
+
+// Turns a level and a seed into the run's spawns, one chunk at a time. It
+// replays the level's speed curve tick by tick and rolls the level's per-tick
+// spawn chances, so a level spawns as often as its dice say, then drops
+// anything unfair: an obstacle too close behind another to land and jump
+// again (two high ones are fine, the player just stays down), and coins or
+// powerups drawn over an obstacle.
+class SpawnGenerator {
+public:
+    void reset(const LevelConfig& level, uint64_t seed);
+
+    // Appends the next chunk's events, in distance order, and returns the
+    // distance the chunk ends at.
+    double generate(std::vector<SpawnEvent>& events);
+
+private:
+    void rollTick(std::vector<SpawnEvent>& events, size_t chunkStart);
+    bool clearOfObstacle(const ObjectShape& shape) const;
+
+    const LevelConfig* level = nullptr;
+    Rng rng;
+    long long tick = 0;
+    float speed = 0;
+    double distance = 0;
+    double chunkEnd = 0;
+    std::vector<SpawnEvent> carried; // Rolled past the last chunk's end
+    float jumpTicks = 0; // Time in the air for one jump
+    double lastObstacle = 0;
+    bool lastObstacleHigh = false;
+    bool anyObstacle = false;
+};
+
+struct SpawnWorker;
+
+// A run's spawn schedule, handed out in distance order. Chunks are made on
+// demand by default; after startWorker() a background thread keeps
+// SPAWN_RING_CHUNKS of them ready in a ring buffer instead, so a tick only
+// ever swaps in a finished chunk. Both ways produce the same events, so a
+// seed plays out identically with or without the worker.
+class SpawnSchedule {
+public:
+    SpawnSchedule();
+    ~SpawnSchedule();
+    SpawnSchedule(SpawnSchedule&&);
+    SpawnSchedule& operator=(SpawnSchedule&&);
+
+    // Starts the schedule over; level must outlive it.
+    void reset(const LevelConfig& level, uint64_t seed);
+
+    // Moves generation to a background thread, restarting the schedule if
+    // it was already in use.
+    void startWorker();
+
+    // Takes the next event at or before distance; false if there is none yet.
+    bool next(double distance, SpawnEvent& event) {
+        while (cursor == current.size()) {
+            if (distance < currentEnd) return false;
+            takeChunk();
+        }
+        if (current[cursor].distance > distance) return false;
+        event = current[cursor++];
+        return true;
+    }
+
+private:
+    void takeChunk();
+
+    const LevelConfig* level = nullptr; // From the last reset()
+    uint64_t seed = 0;
+    SpawnGenerator generator;
+    std::vector<SpawnEvent> current;
+    size_t cursor = 0;
+    double currentEnd = 0;
+    std::unique_ptr<SpawnWorker> worker;
+};
+
+#endif
@@ -0,0 +1,168 @@
+#include "GLIncludes.h"
+#include "TextRenderer.h"
+#include "CoreProfile.h"
+#include <cstdio>
+
+static const int ATLAS_WIDTH = 512;
+static const int ATLAS_HEIGHT = 128;
+// Space around each glyph for bitmaps that start left of the pen or reach
+// below the baseline
+static const int PAD = 2;
+
+static void* const GLUT_FONTS[FONT_COUNT] = {GLUT_BITMAP_HELVETICA_12, GLUT_BITMAP_HELVETICA_18};
+static const int CELL_HEIGHT[FONT_COUNT] = {16, 24};
+static const int DESCENT[FONT_COUNT] = {4, 6};
+
+void TextRenderer::bake() {
+    GLuint framebuffer = 0;
+    GLuint colorBuffer = 0;
+    glGenFramebuffers(1, &framebuffer);
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, ATLAS_WIDTH, ATLAS_HEIGHT);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+
+    // Draw every glyph white on black, one pixel per unit, and remember
+    // where each one went
+    glViewport(0, 0, ATLAS_WIDTH, ATLAS_HEIGHT);
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    gluOrtho2D(0, ATLAS_WIDTH, 0, ATLAS_HEIGHT);
+    glMatrixMode(GL_MODELVIEW);
+    glLoadIdentity();
+    glClear(GL_COLOR_BUFFER_BIT);
+    glColor3f(1.0f, 1.0f, 1.0f);
+
+    int x = 0;
+    int y = 0;
+    for (int font = 0; font < FONT_COUNT; font++) {
+        for (int c = FIRST_CHAR; c <= LAST_CHAR; c++) {
+            int advance = glutBitmapWidth(GLUT_FONTS[font], c);
+            int width = advance + 2 * PAD;
+            if (x + width > ATLAS_WIDTH) {
+                x = 0;
+                y += CELL_HEIGHT[font];
+            }
+            glRasterPos2i(x + PAD, y + DESCENT[font]);
+            glutBitmapCharacter(GLUT_FONTS[font], c);
+            glyphs[font][c - FIRST_CHAR] = {x, y, width, advance};
+            x += width;
+        }
+        x = 0;
+        y += CELL_HEIGHT[font];
+    }
+    if (y > ATLAS_HEIGHT) {
+        fprintf(stderr, "Glyph atlas does not fit; text may be clipped\n");
+    }
+
+    pixels.resize(ATLAS_WIDTH * ATLAS_HEIGHT);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glReadPixels(0, 0, ATLAS_WIDTH, ATLAS_HEIGHT, GL_RED, GL_UNSIGNED_BYTE, pixels.data());
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteRenderbuffers(1, &colorBuffer);
+}
+
+void TextRenderer::upload() {
+    if (pixels.empty()) return;
+
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    // Alpha textures are gone from the core profile; its shader reads red
+    if (coreProfileActive()) {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, ATLAS_WIDTH, ATLAS_HEIGHT, 0, GL_RED, GL_UNSIGNED_BYTE, pixels.data());
+    } else {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, ATLAS_WIDTH, ATLAS_HEIGHT, 0, GL_ALPHA, GL_UNSIGNED_BYTE,
+                     pixels.data());
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    std::vector<unsigned char>().swap(pixels);
+}
+
+void TextRenderer::layout(TextFont font, const char* text, float x, float y, float r, float g, float b,
+                          std::vector<TextVertex>& out) const {
+    float height = CELL_HEIGHT[font];
+    float bottom = y - DESCENT[font];
+    for (const char* c = text; *c; c++) {
+        if (*c < FIRST_CHAR || *c > LAST_CHAR) continue;
+        const Glyph& glyph = glyphs[font][*c - FIRST_CHAR];
+
+        float left = x - PAD;
+        float right = left + glyph.width;
+        float top = bottom + height;
+        float u0 = float(glyph.x) / ATLAS_WIDTH;
+        float u1 = float(glyph.x + glyph.width) / ATLAS_WIDTH;
+        float v0 = float(glyph.y) / ATLAS_HEIGHT;
+        float v1 = float(glyph.y + height) / ATLAS_HEIGHT;
+
+        TextVertex corners[4] = {
+            {left, bottom, u0, v0, r, g, b, 1},
+            {right, bottom, u1, v0, r, g, b, 1},
+            {right, top, u1, v1, r, g, b, 1},
+            {left, top, u0, v1, r, g, b, 1},
+        };
+        const int order[6] = {0, 1, 2, 0, 2, 3};
+        for (int i : order) {
+            out.push_back(corners[i]);
+        }
+        x += glyph.advance;
+    }
+}
+
+void TextRenderer::draw(const std::vector<TextVertex>& vertices) const {
+    if (vertices.empty() || texture == 0) return;
+    if (coreProfileActive()) {
+        drawCoreText(texture, vertices.data(), int(vertices.size()));
+        return;
+    }
+
+    glEnable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(2, GL_FLOAT, sizeof(TextVertex), &vertices[0].x);
+    glTexCoordPointer(2, GL_FLOAT, sizeof(TextVertex), &vertices[0].u);
+    glColorPointer(4, GL_FLOAT, sizeof(TextVertex), &vertices[0].r);
+    glDrawArrays(GL_TRIANGLES, 0, GLsizei(vertices.size()));
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+
+    glDisable(GL_BLEND);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glDisable(GL_TEXTURE_2D);
+}
+
+void TextLabel::emit(const TextRenderer& text, int newValue, std::vector<TextVertex>& out) {
+    if (!valid || newValue != value) {
+        char line[64];
+        snprintf(line, sizeof(line), "%s%d", prefix, newValue);
+        value = newValue;
+        rebuild(text, line);
+    }
+    out.insert(out.end(), vertices.begin(), vertices.end());
+}
+
+void TextLabel::emit(const TextRenderer& text, std::vector<TextVertex>& out) {
+    if (!valid) {
+        rebuild(text, prefix);
+    }
+    out.insert(out.end(), vertices.begin(), vertices.end());
+}
+
+void TextLabel::rebuild(const TextRenderer& text, const char* line) {
+    vertices.clear();
+    text.layout(font, line, x, y, r, g, b, vertices);
+    valid = true;
+}
@@ -0,0 +1,78 @@
+#ifndef TEXT_RENDERER_H
+#define TEXT_RENDERER_H
+
+#include <vector>
+
+// The two GLUT bitmap fonts the game uses
+enum TextFont {
+    FONT_SMALL, // GLUT_BITMAP_HELVETICA_12
+    FONT_LARGE, // GLUT_BITMAP_HELVETICA_18
+    FONT_COUNT
+};
+
+struct TextVertex {
+    float x, y;
+    float u, v;
+    float r, g, b, a;
+};
+
+// Draws text as textured quads from an atlas of the GLUT bitmap fonts, so a
+// whole screen of text is one draw call instead of a glutBitmapCharacter
+// call per character.
+class TextRenderer {
+public:
+    // Renders printable ASCII in both fonts once through glutBitmapCharacter
+    // into an offscreen framebuffer and keeps the pixels. Needs a current
+    // compatibility context (bitmaps are gone from the core profile), but
+    // not a mapped window.
+    void bake();
+    // Creates the atlas texture from the baked pixels in the current
+    // context, which may be a different one from bake()'s.
+    void upload();
+    bool baked() const { return texture != 0; }
+
+    // Appends quads for text with its baseline starting at (x, y).
+    void layout(TextFont font, const char* text, float x, float y, float r, float g, float b,
+                std::vector<TextVertex>& out) const;
+    void draw(const std::vector<TextVertex>& vertices) const;
+
+private:
+    struct Glyph {
+        int x, y;    // Cell origin in the atlas
+        int width;   // Cell width
+        int advance;
+    };
+
+    static const int FIRST_CHAR = 32;
+    static const int LAST_CHAR = 126;
+
+    Glyph glyphs[FONT_COUNT][LAST_CHAR - FIRST_CHAR + 1] = {};
+    std::vector<unsigned char> pixels; // Between bake() and upload()
+    unsigned int texture = 0;
+};
+
+// One line of text with a fixed prefix and position whose quads are kept
+// between frames and rebuilt only when the value shown changes.
+class TextLabel {
+public:
+    TextLabel(TextFont font, float x, float y, float r, float g, float b, const char* prefix)
+        : font(font), x(x), y(y), r(r), g(g), b(b), prefix(prefix) {}
+
+    // Appends the label showing value to out.
+    void emit(const TextRenderer& text, int value, std::vector<TextVertex>& out);
+    // As above for labels without a number.
+    void emit(const TextRenderer& text, std::vector<TextVertex>& out);
+
+private:
+    void rebuild(const TextRenderer& text, const char* line);
+
+    TextFont font;
+    float x, y;
+    float r, g, b;
+    const char* prefix;
+    bool valid = false;
+    int value = 0;
+    std::vector<TextVertex> vertices;
+};
+
+#endif
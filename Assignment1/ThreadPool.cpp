@@ -0,0 +1,79 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(int threads) {
+    if (threads <= 0) {
+        threads = int(std::thread::hardware_concurrency());
+        if (threads <= 0) threads = 1;
+    }
+    spans = std::vector<Span>(threads);
+    workers.reserve(threads - 1);
+    for (int i = 1; i < threads; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::run(int taskCount, TaskFn task, void* context) {
+    if (taskCount <= 0) return;
+
+    int threads = threadCount();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->task = task;
+        this->context = context;
+        for (int i = 0; i < threads; i++) {
+            spans[i].next.store(int((long long)taskCount * i / threads), std::memory_order_relaxed);
+            spans[i].end = int((long long)taskCount * (i + 1) / threads);
+        }
+        busy = threads - 1;
+        generation++;
+    }
+    wake.notify_all();
+
+    work(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this] { return busy == 0; });
+}
+
+void ThreadPool::workerLoop(int worker) {
+    unsigned seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+
+        work(worker);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--busy == 0) {
+            finished.notify_one();
+        }
+    }
+}
+
+// Drains this thread's own span first, then visits the others in turn.
+void ThreadPool::work(int worker) {
+    int threads = threadCount();
+    for (int k = 0; k < threads; k++) {
+        Span& span = spans[(worker + k) % threads];
+        for (;;) {
+            int next = span.next.fetch_add(1, std::memory_order_relaxed);
+            if (next >= span.end) break;
+            task(context, next);
+        }
+    }
+}
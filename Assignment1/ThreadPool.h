@@ -0,0 +1,54 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads that run one job at a time. A job is tasks
+// 0..taskCount, dealt out to the threads in contiguous spans; a thread that
+// runs out of its own span steals tasks from the others' until every span is
+// drained. Nothing is allocated per job, so it can be driven every tick.
+class ThreadPool {
+public:
+    typedef void (*TaskFn)(void* context, int task);
+
+    // threads counts the calling thread, which works too; 0 means one per
+    // hardware thread.
+    explicit ThreadPool(int threads = 0);
+    ~ThreadPool();
+
+    int threadCount() const { return int(workers.size()) + 1; }
+
+    // Runs task(context, i) for every i in [0, taskCount) and returns once
+    // all have finished. Not reentrant.
+    void run(int taskCount, TaskFn task, void* context);
+
+private:
+    // One thread's share of the current job. Owner and thieves both take
+    // from the front, so a single atomic counter is all the queue needs.
+    struct alignas(64) Span {
+        std::atomic<int> next{0};
+        int end = 0;
+    };
+
+    void workerLoop(int worker);
+    void work(int worker);
+
+    std::vector<std::thread> workers;
+    std::vector<Span> spans;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    unsigned generation = 0;
+    int busy = 0;
+    bool stopping = false;
+
+    TaskFn task = nullptr;
+    void* context = nullptr;
+};
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+
+// Hands the newest of a stream of values from one writer thread to one reader
+// thread without locks or waiting. The writer fills writeBuffer() and
+// publishes it; the reader always gets the latest published value and
+// intermediate ones are skipped. Three buffers mean each side always owns
+// one outright and the third is swapped between them atomically.
+template <typename T>
+class TripleBuffer {
+public:
+    // Writer side
+    T& writeBuffer() { return buffers[writeIndex]; }
+    void publish() {
+        writeIndex = spare.exchange(writeIndex | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // Reader side: switches to the newest published value if there is one.
+    // The reference stays valid until the next call.
+    const T& read() {
+        if (spare.load(std::memory_order_relaxed) & FRESH) {
+            readIndex = spare.exchange(readIndex, std::memory_order_acq_rel) & INDEX_MASK;
+        }
+        return buffers[readIndex];
+    }
+
+private:
+    static const int INDEX_MASK = 3;
+    static const int FRESH = 4; // Set while the spare holds a value the reader has not seen
+
+    T buffers[3];
+    alignas(64) std::atomic<int> spare{1};
+    alignas(64) int writeIndex = 0;
+    alignas(64) int readIndex = 2;
+};
+
+#endif
@@ -0,0 +1,109 @@
+#include "VecEnv.h"
+#include <algorithm>
+
+// Runs per task. Small enough that every thread gets several batches to
+// balance with, large enough that task dispatch stays in the noise.
+static const int MIN_BATCH = 16;
+static const int BATCHES_PER_THREAD = 8;
+
+void observe(const RunnerWorld& world, float* out) {
+    float obstacleDistance = WINDOW_WIDTH;
+    bool obstacleHigh = false;
+    const EntityPool& obstacles = world.obstacles;
+    for (int i = 0; i < obstacles.size(); i++) {
+        float distance = obstacles.x[i] - world.playerX;
+        if (distance > 0 && distance < obstacleDistance) {
+            obstacleDistance = distance;
+            obstacleHigh = obstacles.isHighObstacle[i] != 0;
+        }
+    }
+
+    float coinDistance = WINDOW_WIDTH;
+    float coinHeight = 0;
+    const EntityPool& collectables = world.collectables;
+    for (int i = 0; i < collectables.size(); i++) {
+        float distance = collectables.x[i] - world.playerX;
+        if (distance > 0 && distance < coinDistance) {
+            coinDistance = distance;
+            coinHeight = collectables.y[i] - world.playerY;
+        }
+    }
+
+    out[OBS_PLAYER_HEIGHT] = world.playerY - GROUND_HEIGHT;
+    out[OBS_JUMP_VELOCITY] = world.jumpVelocity;
+    out[OBS_DUCKING] = world.isDucking ? 1.0f : 0.0f;
+    out[OBS_GAME_SPEED] = world.gameSpeed;
+    out[OBS_OBSTACLE_DISTANCE] = obstacleDistance;
+    out[OBS_OBSTACLE_HIGH] = obstacleHigh ? 1.0f : 0.0f;
+    out[OBS_COIN_DISTANCE] = coinDistance;
+    out[OBS_COIN_HEIGHT] = coinHeight;
+    out[OBS_HEALTH] = float(world.health);
+}
+
+VecEnv::VecEnv(int count, uint64_t seed, int threads, int poolCapacity)
+    : obs(size_t(count) * OBSERVATION_SIZE), reward(count), done(count), finished(count),
+      seed(seed), pool(threads) {
+    worlds.reserve(count);
+    for (int i = 0; i < count; i++) {
+        worlds.emplace_back(poolCapacity);
+    }
+    batchSize = std::max(MIN_BATCH, count / (pool.threadCount() * BATCHES_PER_THREAD));
+    reset();
+}
+
+void VecEnv::reset() {
+    for (int i = 0; i < size(); i++) {
+        worlds[i].seed = seed + uint64_t(i);
+        worlds[i].reset();
+        observe(worlds[i], &obs[size_t(i) * OBSERVATION_SIZE]);
+        reward[i] = 0;
+        done[i] = 0;
+        finished[i] = 0;
+    }
+}
+
+void VecEnv::setLevel(const LevelConfig& level) {
+    for (RunnerWorld& world : worlds) {
+        world.level = &level;
+    }
+    reset();
+}
+
+void VecEnv::step(const uint8_t* actions) {
+    this->actions = actions;
+    int batches = (size() + batchSize - 1) / batchSize;
+    pool.run(batches, stepBatch, this);
+}
+
+void VecEnv::stepBatch(void* self, int batch) {
+    VecEnv& env = *static_cast<VecEnv*>(self);
+    int count = env.size();
+    int begin = batch * env.batchSize;
+    int end = std::min(count, begin + env.batchSize);
+    for (int i = begin; i < end; i++) {
+        RunnerWorld& world = env.worlds[i];
+        int score = world.score;
+        int health = world.health;
+
+        world.applyInput(RunnerInput::fromBits(env.actions[i]));
+        world.step();
+
+        env.reward[i] = float((world.score - score) - (health - world.health));
+        env.done[i] = world.gameOver;
+        if (world.gameOver) {
+            // Seeds seed + i + k * count never collide between runs
+            env.finished[i]++;
+            world.seed += uint64_t(count);
+            world.reset();
+        }
+        observe(world, &env.obs[size_t(i) * OBSERVATION_SIZE]);
+    }
+}
+
+long long VecEnv::episodes() const {
+    long long total = 0;
+    for (long long count : finished) {
+        total += count;
+    }
+    return total;
+}
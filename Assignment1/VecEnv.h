@@ -0,0 +1,71 @@
+#ifndef VEC_ENV_H
+#define VEC_ENV_H
+
+#include "RunnerWorld.h"
+#include "ThreadPool.h"
+#include <cstdint>
+#include <vector>
+
+// Observation layout, one row of OBSERVATION_SIZE floats per run
+enum Observation {
+    OBS_PLAYER_HEIGHT,      // Player y above the ground
+    OBS_JUMP_VELOCITY,
+    OBS_DUCKING,            // 0 or 1
+    OBS_GAME_SPEED,
+    OBS_OBSTACLE_DISTANCE,  // To the nearest obstacle ahead, WINDOW_WIDTH if none
+    OBS_OBSTACLE_HIGH,      // 1 if that obstacle has to be ducked under
+    OBS_COIN_DISTANCE,      // To the nearest collectable ahead, WINDOW_WIDTH if none
+    OBS_COIN_HEIGHT,        // Its y relative to the player
+    OBS_HEALTH,
+    OBSERVATION_SIZE
+};
+
+// Writes world's observation row to out.
+void observe(const RunnerWorld& world, float* out);
+
+// Many independent runs stepped in lockstep on a thread pool, for training
+// and evaluating bots. Run i starts from seed + i; when a run ends it is
+// reset straight away with a seed no other run has used, so every step()
+// advances all of them.
+//
+// Observations, rewards and done flags live in contiguous arrays indexed by
+// run. Reward is points collected minus lives lost on that step. All storage
+// is allocated up front, so step() never allocates.
+class VecEnv {
+public:
+    // threads as for ThreadPool: 0 means one per hardware thread.
+    VecEnv(int count, uint64_t seed, int threads = 0, int poolCapacity = POOL_CAPACITY);
+
+    // Restarts every run from its initial seed.
+    void reset();
+    // Plays every run on level (which must outlive the env) and restarts
+    // them all.
+    void setLevel(const LevelConfig& level);
+    // Applies actions[i] (RunnerInput::bits()) to run i and steps every run
+    // by one tick.
+    void step(const uint8_t* actions);
+
+    int size() const { return int(worlds.size()); }
+    int threadCount() const { return pool.threadCount(); }
+    const RunnerWorld& world(int index) const { return worlds[index]; }
+
+    const float* observations() const { return obs.data(); }  // size() * OBSERVATION_SIZE
+    const float* rewards() const { return reward.data(); }
+    const uint8_t* dones() const { return done.data(); }      // 1 if the run ended on the last step
+    long long episodes() const;                               // Runs finished since reset()
+
+private:
+    static void stepBatch(void* self, int batch);
+
+    std::vector<RunnerWorld> worlds;
+    std::vector<float> obs;
+    std::vector<float> reward;
+    std::vector<uint8_t> done;
+    std::vector<long long> finished; // Per run, so batches never share a counter
+    uint64_t seed;
+    int batchSize;
+    const uint8_t* actions = nullptr;
+    ThreadPool pool;
+};
+
+#endif
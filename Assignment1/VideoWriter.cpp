@@ -0,0 +1,199 @@
+#include "VideoWriter.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+VideoWriter::~VideoWriter() {
+    close();
+}
+
+bool VideoWriter::open(const char* file, int width, int height, int fps) {
+    close();
+    path = file;
+    size_t length = path.size();
+    y4m = length >= 4 && path.compare(length - 4, 4, ".y4m") == 0;
+    if (!y4m && !parsePattern()) {
+        fprintf(stderr, "Capture path %s is neither a .y4m file nor a pattern with one %%d like frame%%05d.ppm\n", file);
+        return false;
+    }
+    if (width <= 0 || height <= 0 || fps <= 0) return false;
+
+    if (y4m) {
+        stream = fopen(file, "wb");
+        if (!stream) {
+            fprintf(stderr, "Could not write %s\n", file);
+            return false;
+        }
+        fprintf(stream, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", width, height, fps);
+        int chroma = ((width + 1) / 2) * ((height + 1) / 2);
+        planes.resize(size_t(width) * height + 2 * size_t(chroma));
+    }
+
+    frameWidth = width;
+    frameHeight = height;
+    slots.assign(QUEUE_FRAMES, std::vector<uint8_t>(size_t(width) * height * 4));
+    head = 0;
+    count = 0;
+    closing = false;
+    failed = false;
+    written = 0;
+    dropped = 0;
+    thread = std::thread(&VideoWriter::writeLoop, this);
+    return true;
+}
+
+// Accepts literal text, %% and exactly one %d, %Nd or %0Nd
+bool VideoWriter::parsePattern() {
+    namePrefix.clear();
+    nameSuffix.clear();
+    numberWidth = 0;
+    zeroPad = false;
+    bool found = false;
+    for (size_t i = 0; i < path.size(); i++) {
+        std::string& out = found ? nameSuffix : namePrefix;
+        if (path[i] != '%') {
+            out += path[i];
+            continue;
+        }
+        i++;
+        if (i < path.size() && path[i] == '%') {
+            out += '%';
+            continue;
+        }
+        if (found) return false;
+        if (i < path.size() && path[i] == '0') {
+            zeroPad = true;
+            i++;
+        }
+        while (i < path.size() && isdigit((unsigned char)path[i])) {
+            numberWidth = numberWidth * 10 + (path[i] - '0');
+            if (numberWidth > 20) return false;
+            i++;
+        }
+        if (i == path.size() || path[i] != 'd') return false;
+        found = true;
+    }
+    return found;
+}
+
+uint8_t* VideoWriter::nextFrame(bool wait) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (count == QUEUE_FRAMES) {
+        if (!wait) {
+            dropped++;
+            return nullptr;
+        }
+        slotFree.wait(lock, [this] { return count < QUEUE_FRAMES; });
+    }
+    return slots[(head + count) % QUEUE_FRAMES].data();
+}
+
+void VideoWriter::submit() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        count++;
+    }
+    frameReady.notify_one();
+}
+
+void VideoWriter::dropFrame() {
+    std::lock_guard<std::mutex> lock(mutex);
+    dropped++;
+}
+
+bool VideoWriter::close() {
+    if (!thread.joinable()) return true;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closing = true;
+    }
+    frameReady.notify_one();
+    thread.join();
+    if (stream) {
+        failed = fclose(stream) != 0 || failed;
+        stream = nullptr;
+    }
+    return !failed;
+}
+
+void VideoWriter::writeLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        frameReady.wait(lock, [this] { return count > 0 || closing; });
+        if (count == 0) return;
+
+        // The slot stays queued while it is written, so the producer cannot
+        // reuse it yet
+        const uint8_t* frame = slots[head].data();
+        lock.unlock();
+        bool ok = !failed && writeFrame(frame);
+        lock.lock();
+        if (ok) {
+            written++;
+        } else if (!failed) {
+            fprintf(stderr, "Could not write captured frame %lld to %s\n", written, path.c_str());
+            failed = true;
+        }
+        head = (head + 1) % QUEUE_FRAMES;
+        count--;
+        slotFree.notify_one();
+    }
+}
+
+// BT.601 full-range conversion in 16.16 fixed point
+static inline uint8_t lumaOf(const uint8_t* p) {
+    return uint8_t((19595 * p[0] + 38470 * p[1] + 7471 * p[2] + 32768) >> 16);
+}
+
+bool VideoWriter::writeFrame(const uint8_t* rgba) {
+    int w = frameWidth, h = frameHeight;
+    size_t rowBytes = size_t(w) * 4;
+
+    if (!y4m) {
+        char number[32];
+        snprintf(number, sizeof(number), zeroPad ? "%0*lld" : "%*lld", numberWidth, written);
+        std::string name = namePrefix + number + nameSuffix;
+        FILE* file = fopen(name.c_str(), "wb");
+        if (!file) return false;
+        fprintf(file, "P6\n%d %d\n255\n", w, h);
+        // planes holds one RGB row at a time here
+        planes.resize(size_t(w) * 3);
+        bool ok = true;
+        for (int y = h - 1; y >= 0 && ok; y--) {
+            const uint8_t* row = rgba + size_t(y) * rowBytes;
+            for (int x = 0; x < w; x++) {
+                memcpy(&planes[size_t(x) * 3], row + size_t(x) * 4, 3);
+            }
+            ok = fwrite(planes.data(), 1, planes.size(), file) == planes.size();
+        }
+        return fclose(file) == 0 && ok;
+    }
+
+    int cw = (w + 1) / 2, ch = (h + 1) / 2;
+    uint8_t* luma = planes.data();
+    uint8_t* cb = luma + size_t(w) * h;
+    uint8_t* cr = cb + size_t(cw) * ch;
+    for (int y = 0; y < h; y++) {
+        const uint8_t* row = rgba + size_t(h - 1 - y) * rowBytes;
+        for (int x = 0; x < w; x++) {
+            luma[size_t(y) * w + x] = lumaOf(row + size_t(x) * 4);
+        }
+    }
+    // Chroma from the average of each 2x2 block
+    for (int y = 0; y < ch; y++) {
+        const uint8_t* top = rgba + size_t(h - 1 - 2 * y) * rowBytes;
+        const uint8_t* bottom = 2 * y + 1 < h ? rgba + size_t(h - 2 - 2 * y) * rowBytes : top;
+        for (int x = 0; x < cw; x++) {
+            size_t left = size_t(2 * x) * 4;
+            size_t right = 2 * x + 1 < w ? left + 4 : left;
+            int r = top[left] + top[right] + bottom[left] + bottom[right];
+            int g = top[left + 1] + top[right + 1] + bottom[left + 1] + bottom[right + 1];
+            int b = top[left + 2] + top[right + 2] + bottom[left + 2] + bottom[right + 2];
+            // Sums are 4x the average, folded into the shift; pure blue and
+            // pure red round up to 256
+            cb[size_t(y) * cw + x] = uint8_t(std::min(255, (-11059 * r - 21709 * g + 32768 * b + (128 << 18) + (1 << 17)) >> 18));
+            cr[size_t(y) * cw + x] = uint8_t(std::min(255, (32768 * r - 27439 * g - 5329 * b + (128 << 18) + (1 << 17)) >> 18));
+        }
+    }
+    return fputs("FRAME\n", stream) >= 0 && fwrite(planes.data(), 1, planes.size(), stream) == planes.size();
+}
@@ -0,0 +1,78 @@
+#ifndef VIDEO_WRITER_H
+#define VIDEO_WRITER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Streams captured frames to disk on its own thread. Frames go through a
+// bounded queue of QUEUE_FRAMES preallocated buffers, so capturing never
+// allocates and a slow disk costs dropped frames (or, for callers that ask
+// to wait, back-pressure) rather than an ever-growing backlog.
+//
+// A path ending in .y4m gets one YUV4MPEG2 stream (4:2:0, full range), which
+// ffmpeg and most players read directly; any other path names a numbered PPM
+// sequence with exactly one %d, optionally zero-padded to a width, such as
+// frames/%05d.ppm. %% stands for a literal percent sign.
+class VideoWriter {
+public:
+    static const int QUEUE_FRAMES = 8;
+
+    ~VideoWriter();
+
+    // Starts the writer thread for width x height frames at fps.
+    bool open(const char* path, int width, int height, int fps);
+    bool isOpen() const { return thread.joinable(); }
+    int width() const { return frameWidth; }
+    int height() const { return frameHeight; }
+
+    // Buffer for the next frame: width * height RGBA pixels, rows bottom to
+    // top as GL reads them. When the writer is a whole queue behind, waits
+    // for it if wait is set and otherwise drops the frame and returns null.
+    uint8_t* nextFrame(bool wait);
+    // Queues the frame filled since nextFrame().
+    void submit();
+    // Counts a frame the caller could not capture as dropped.
+    void dropFrame();
+
+    // Writes out every queued frame and stops; false if any write failed.
+    bool close();
+
+    long long framesWritten() const { return written; }
+    long long framesDropped() const { return dropped; }
+
+private:
+    void writeLoop();
+    bool parsePattern();
+    bool writeFrame(const uint8_t* rgba);
+
+    std::string path;
+    bool y4m = false;
+    // A PPM pattern split around its %d; the frame number is spliced in
+    // between rather than passing the path to printf
+    std::string namePrefix, nameSuffix;
+    int numberWidth = 0;
+    bool zeroPad = false;
+    FILE* stream = nullptr; // The .y4m file
+    int frameWidth = 0, frameHeight = 0;
+    std::vector<uint8_t> planes; // Y4M conversion scratch, writer thread only
+
+    std::vector<std::vector<uint8_t>> slots;
+    int head = 0;  // Oldest queued frame
+    int count = 0; // Frames queued
+    bool closing = false;
+    bool failed = false;
+    std::mutex mutex;
+    std::condition_variable frameReady;
+    std::condition_variable slotFree;
+    std::thread thread;
+
+    long long written = 0; // Only read once the writer has stopped
+    long long dropped = 0;
+};
+
+#endif
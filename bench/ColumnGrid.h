@@ -0,0 +1,60 @@
+#ifndef COLUMN_GRID_H
+#define COLUMN_GRID_H
+
+#include <vector>
+
+// The column-grid broadphase collisions used before the pools became
+// structure of arrays, kept here as the baseline BM_CollideGrid measures
+// the vector sweep against. Objects are bucketed by x into screen columns
+// with a counting sort, and only the columns around the target are visited.
+class ColumnGrid {
+public:
+    // Objects left of minX or right of maxX land in the first or last column.
+    ColumnGrid(float minX, float maxX, float cellWidth, int capacity)
+        : minX(minX), inverseCellWidth(1.0f / cellWidth), cellCount(int((maxX - minX) / cellWidth) + 1),
+          cellStart(cellCount + 1), cellIds(capacity), indices(capacity) {}
+
+    void build(const float* x, int count) {
+        for (int& start : cellStart) start = 0;
+        for (int i = 0; i < count; i++) {
+            cellIds[i] = cellOf(x[i]);
+            cellStart[cellIds[i] + 1]++;
+        }
+        for (int cell = 0; cell < cellCount; cell++) cellStart[cell + 1] += cellStart[cell];
+        for (int i = 0; i < count; i++) {
+            indices[cellStart[cellIds[i]]++] = i;
+        }
+        // The scatter advanced each start to the next cell's start; shift back
+        for (int cell = cellCount; cell > 0; cell--) cellStart[cell] = cellStart[cell - 1];
+        cellStart[0] = 0;
+    }
+
+    // Calls visit(index) for every object whose column overlaps
+    // [queryMinX, queryMaxX]. Callers still have to test the exact bounds.
+    template <typename F>
+    void query(float queryMinX, float queryMaxX, F&& visit) const {
+        int last = cellOf(queryMaxX);
+        for (int cell = cellOf(queryMinX); cell <= last; cell++) {
+            for (int i = cellStart[cell]; i < cellStart[cell + 1]; i++) {
+                visit(indices[i]);
+            }
+        }
+    }
+
+private:
+    int cellOf(float x) const {
+        int cell = int((x - minX) * inverseCellWidth);
+        if (cell < 0) return 0;
+        if (cell >= cellCount) return cellCount - 1;
+        return cell;
+    }
+
+    float minX;
+    float inverseCellWidth;
+    int cellCount;
+    std::vector<int> cellStart; // cellCount + 1 prefix sums into indices
+    std::vector<int> cellIds;
+    std::vector<int> indices;
+};
+
+#endif
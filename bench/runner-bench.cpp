@@ -0,0 +1,229 @@
+// Benchmarks for the simulation and scene-building hot paths, built on
+// Google Benchmark. Nothing here needs a GPU or a display.
+//
+//   runner-bench --benchmark_out=results.json --benchmark_out_format=json
+//
+// Entity-count benchmarks run from 10 to 1,000,000 live objects, split one
+// quarter obstacles, half collectables, one quarter powerups.
+#include "ColumnGrid.h"
+#include "RunnerWorld.h"
+#include "RunnerScene.h"
+#include "SimdKernels.h"
+#include "SoftRasterizer.h"
+#include "VecEnv.h"
+#include <benchmark/benchmark.h>
+
+// Fills world with count objects scattered over [minX, maxX], in pools with
+// room for count each. Benchmarks hold gameSpeed at 0 (step() raises it every
+// tick) so nothing scrolls away and every iteration sees the same workload.
+// With no speed the world's distance never advances, so the spawn schedule
+// never has anything due and nothing new spawns.
+static void populate(RunnerWorld& world, int count, float minX, float maxX, float minY) {
+    world.seed = 7;
+    world.reset();
+    world.gameSpeed = 0;
+    world.gameTime = 1 << 30;
+
+    Rng rng(11);
+    auto randomX = [&]() { return minX + (maxX - minX) * (rng.next() / 4294967296.0f); };
+    for (int i = 0; i < count; i++) {
+        float x = randomX();
+        float y = minY + rng.below(100);
+        GameObject obj = {x, y, x, y, 0, rng.below(2) == 0};
+        if (i % 4 == 0) {
+            world.obstacles.spawn(obj);
+        } else if (i % 4 == 3) {
+            world.powerups.spawn(obj);
+        } else {
+            world.collectables.spawn(obj);
+        }
+    }
+}
+
+static void entityCounts(benchmark::internal::Benchmark* bench) {
+    bench->RangeMultiplier(10)->Range(10, 1000000);
+}
+
+// Full tick with every object ahead of the player: movement, culling, the
+// spawn schedule check (nothing is due) and the collision sweeps (which find
+// nothing).
+static void BM_StepEntities(benchmark::State& state) {
+    int count = int(state.range(0));
+    RunnerWorld world(count);
+    populate(world, count, 300, WINDOW_WIDTH, GROUND_HEIGHT);
+    for (auto _ : state) {
+        world.gameSpeed = 0;
+        world.step();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_StepEntities)->Apply(entityCounts);
+
+// Same, with the coin magnet pulling on every collectable in range.
+static void BM_StepMagnet(benchmark::State& state) {
+    int count = int(state.range(0));
+    RunnerWorld world(count);
+    populate(world, count, 300, WINDOW_WIDTH, GROUND_HEIGHT);
+    for (auto _ : state) {
+        world.gameSpeed = 0;
+        world.coinMagnet = true;
+        world.coinMagnetTime = POWERUP_DURATION;
+        world.step();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_StepMagnet)->Apply(entityCounts);
+
+// Collision phase alone, with every object overlapping the player in x but
+// above it, so every x test passes and nothing is removed.
+static void BM_Collision(benchmark::State& state) {
+    int count = int(state.range(0));
+    RunnerWorld world(count);
+    populate(world, count, world.playerX - 20, world.playerX + 20, WINDOW_HEIGHT - 150);
+    for (auto _ : state) {
+        world.checkCollisions();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_Collision)->Apply(entityCounts);
+
+// Broadphase choice: one pool spread over the whole screen (the case a grid
+// is for), the player box tested against it by the vector sweep the world
+// uses and by the column grid it replaced, rebuilt every tick as it was.
+static void BM_CollideSweep(benchmark::State& state) {
+    int count = int(state.range(0));
+    RunnerWorld world(count);
+    populate(world, count, 0, WINDOW_WIDTH, GROUND_HEIGHT);
+    const EntityPool& pool = world.collectables;
+    Box player = world.playerBox();
+    std::vector<int> hits(pool.size());
+    for (auto _ : state) {
+        int found = findOverlaps(pool.x.data(), pool.y.data(), pool.isHighObstacle.data(), pool.size(),
+                                 COLLECTABLE_SHAPE, player, hits.data());
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * pool.size());
+}
+BENCHMARK(BM_CollideSweep)->Apply(entityCounts);
+
+static void BM_CollideGrid(benchmark::State& state) {
+    int count = int(state.range(0));
+    RunnerWorld world(count);
+    populate(world, count, 0, WINDOW_WIDTH, GROUND_HEIGHT);
+    const EntityPool& pool = world.collectables;
+    Box player = world.playerBox();
+    ColumnGrid grid(0, WINDOW_WIDTH, 50, pool.size());
+    for (auto _ : state) {
+        grid.build(pool.x.data(), pool.size());
+        int found = 0;
+        grid.query(player.minX - COLLECTABLE_SHAPE.maxDX, player.maxX - COLLECTABLE_SHAPE.minDX, [&](int i) {
+            Box box = objectBox(COLLECTABLE_SHAPE, pool.x[i], pool.y[i], pool.isHighObstacle[i]);
+            found += overlaps(box, player);
+        });
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * pool.size());
+}
+BENCHMARK(BM_CollideGrid)->Apply(entityCounts);
+
+// Spawning at the starting speed, including generating the schedule chunk
+// by chunk, emptying the pools whenever they fill up.
+static void BM_Spawn(benchmark::State& state) {
+    RunnerWorld world;
+    world.seed = 3;
+    world.reset();
+    for (auto _ : state) {
+        world.distance += world.gameSpeed;
+        world.spawnObjects();
+        if (world.collectables.size() == world.collectables.capacity()) {
+            world.obstacles.clear();
+            world.collectables.clear();
+            world.powerups.clear();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Spawn);
+
+// One lockstep tick of many independent runs, on 1 thread and on every
+// hardware thread. Runs that end are reset inside the step, as in training.
+static void BM_VecEnvStep(benchmark::State& state) {
+    int envs = int(state.range(0));
+    VecEnv env(envs, 5, int(state.range(1)));
+    std::vector<uint8_t> actions(envs);
+    for (int i = 0; i < envs; i++) {
+        actions[i] = uint8_t(i % 3 == 0 ? 1 : 0);
+    }
+    for (auto _ : state) {
+        env.step(actions.data());
+    }
+    state.SetItemsProcessed(state.iterations() * envs);
+    state.counters["threads"] = env.threadCount();
+}
+BENCHMARK(BM_VecEnvStep)->ArgsProduct({{64, 1024, 16384}, {1, 0}})->UseRealTime();
+
+static void BM_BuildSceneMeshes(benchmark::State& state) {
+    for (auto _ : state) {
+        SceneMeshes meshes;
+        buildSceneMeshes(meshes);
+        benchmark::DoNotOptimize(meshes);
+    }
+}
+BENCHMARK(BM_BuildSceneMeshes);
+
+// Instancing every object's mesh into a CPU-side vertex batch, as display()
+// does each frame before upload.
+static void BM_EmitScene(benchmark::State& state) {
+    int count = int(state.range(0));
+    RunnerWorld world(count);
+    populate(world, count, 0, WINDOW_WIDTH, GROUND_HEIGHT);
+    SceneState scene(count);
+    scene.capture(world);
+    SceneMeshes meshes;
+    buildSceneMeshes(meshes);
+    DrawBatch batch;
+    for (auto _ : state) {
+        batch.clear();
+        emitScene(scene, meshes, batch, 0.5f);
+        benchmark::DoNotOptimize(batch.triangles.data());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+    state.SetBytesProcessed(state.iterations() * int64_t(batch.vertexCount()) * int64_t(sizeof(Vertex)));
+    state.counters["vertices"] = batch.vertexCount();
+}
+// Capped at 100,000 objects: a million would need a 2.7 GB batch.
+BENCHMARK(BM_EmitScene)->RangeMultiplier(10)->Range(10, 100000);
+
+// A whole frame (background, objects, hearts) through the software
+// rasterizer at window size, on 1 thread and on every hardware thread.
+static void BM_Rasterize(benchmark::State& state) {
+    int count = int(state.range(0));
+    RunnerWorld world(count);
+    populate(world, count, 0, WINDOW_WIDTH, GROUND_HEIGHT);
+    SceneState scene(count);
+    scene.capture(world);
+    SceneMeshes meshes;
+    buildSceneMeshes(meshes);
+    DrawBatch batch;
+    emitScene(scene, meshes, batch);
+
+    Framebuffer frame;
+    frame.resize(WINDOW_WIDTH, WINDOW_HEIGHT);
+    SoftRasterizer raster(int(state.range(1)));
+    for (auto _ : state) {
+        frame.clear(0, 0, 0);
+        raster.begin(frame, WINDOW_WIDTH, WINDOW_HEIGHT);
+        raster.add(meshes.ground);
+        raster.add(meshes.sky);
+        raster.add(batch);
+        raster.finish();
+        benchmark::DoNotOptimize(frame.pixels.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["pixels/s"] = benchmark::Counter(double(state.iterations()) * WINDOW_WIDTH * WINDOW_HEIGHT,
+                                                    benchmark::Counter::kIsRate);
+    state.counters["threads"] = raster.threadCount();
+}
+BENCHMARK(BM_Rasterize)->ArgsProduct({{10, 100, 1000}, {1, 0}})->UseRealTime();
+
+BENCHMARK_MAIN();
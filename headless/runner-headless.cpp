@@ -0,0 +1,331 @@
+// Headless driver for the runner simulation. Links only the GL-free sources,
+// so it runs without a display and as fast as the CPU allows.
+//
+//   runner-headless [--frames N] [--seed N] [--record FILE | --replay FILE] [--level FILE]
+//                   [--spawn-thread] [--audio] [--render FILE] [--capture FILE]
+//                   [--render-size WxH] [--render-threads N]
+//   runner-headless --envs N [--threads N] [--frames N] [--seed N] [--level FILE]
+//   runner-headless --level FILE --save-level OUT
+//
+// Without --replay an autopilot plays back-to-back runs seeded seed, seed+1,
+// ... With --replay the recorded run is played over and over as a fixed
+// workload, checking that every pass ends in the same state. With --envs the
+// autopilot plays N runs at once through VecEnv, one tick of all N per frame.
+// --save-level checks a level file and writes it out in the binary format.
+// --spawn-thread generates spawn schedules on a background thread, as the
+// game does; results are the same either way. --audio triggers the game's
+// sounds through the null audio backend, to exercise the mixer. --render draws
+// the final frame with the software rasterizer and writes it to FILE as a PPM;
+// the image hash it prints is the same on every machine and thread count, so
+// a replay's frame can be checked against a known-good one. --capture renders
+// every tick of the first run the same way and streams it to a video (see
+// VideoWriter), waiting for the writer rather than dropping frames.
+#include "RunnerWorld.h"
+#include "Audio.h"
+#include "Replay.h"
+#include "RunnerScene.h"
+#include "SimdKernels.h"
+#include "SoftRasterizer.h"
+#include "VecEnv.h"
+#include "VideoWriter.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <string>
+
+// Jump over low obstacles and duck under high ones as they come close.
+static RunnerInput autopilot(const float* observation) {
+    RunnerInput input;
+    if (observation[OBS_OBSTACLE_DISTANCE] < 60) {
+        if (observation[OBS_OBSTACLE_HIGH] != 0) {
+            input.duck = true;
+        } else {
+            input.jump = true;
+        }
+    }
+    return input;
+}
+
+static RunnerInput autopilot(const RunnerWorld& world) {
+    float observation[OBSERVATION_SIZE];
+    observe(world, observation);
+    return autopilot(observation);
+}
+
+static void usage(const char* program) {
+    fprintf(stderr, "usage: %s [--frames N] [--seed N] [--record FILE | --replay FILE] [--level FILE]\n", program);
+    fprintf(stderr, "       %*s [--spawn-thread] [--audio] [--render FILE] [--capture FILE]\n", int(strlen(program)), "");
+    fprintf(stderr, "       %*s [--render-size WxH] [--render-threads N]\n", int(strlen(program)), "");
+    fprintf(stderr, "       %s --envs N [--threads N] [--frames N] [--seed N] [--level FILE]\n", program);
+    fprintf(stderr, "       %s --level FILE --save-level OUT\n", program);
+    exit(1);
+}
+
+// Stores the run's final checksum alongside its inputs and writes it out.
+static bool saveReplay(Replay& replay, const RunnerWorld& world, const char* path) {
+    replay.checksum = world.checksum();
+    if (!replay.save(path)) {
+        fprintf(stderr, "Could not write replay %s\n", path);
+        return false;
+    }
+    return true;
+}
+
+// Draws worlds as the game would (without the HUD text) on the CPU.
+struct HeadlessRenderer {
+    SceneMeshes meshes;
+    SceneState scene;
+    DrawBatch batch;
+    Framebuffer frame;
+    SoftRasterizer raster;
+
+    HeadlessRenderer(int width, int height, int threads, int poolCapacity) : scene(poolCapacity), raster(threads) {
+        buildSceneMeshes(meshes);
+        frame.resize(width, height);
+    }
+
+    const Framebuffer& draw(const RunnerWorld& world) {
+        scene.capture(world);
+        batch.clear();
+        emitScene(scene, meshes, batch);
+        frame.clear(0, 0, 0);
+        raster.begin(frame, WINDOW_WIDTH, WINDOW_HEIGHT);
+        raster.add(meshes.ground);
+        raster.add(meshes.sky);
+        raster.add(batch);
+        raster.finish();
+        return frame;
+    }
+};
+
+static int runVecEnv(int envs, int threads, long long frames, uint64_t seed, const LevelConfig& level) {
+    VecEnv env(envs, seed, threads);
+    env.setLevel(level);
+    std::vector<uint8_t> actions(envs);
+    double totalReward = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (long long frame = 0; frame < frames; frame++) {
+        const float* observations = env.observations();
+        for (int i = 0; i < envs; i++) {
+            actions[i] = autopilot(observations + size_t(i) * OBSERVATION_SIZE).bits();
+        }
+        env.step(actions.data());
+        for (int i = 0; i < envs; i++) {
+            totalReward += env.rewards()[i];
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    long long steps = frames * envs;
+    printf("envs:        %d on %d threads\n", envs, env.threadCount());
+    printf("frames:      %lld\n", frames);
+    printf("games:       %lld\n", env.episodes());
+    printf("reward/step: %.4f\n", steps ? totalReward / steps : 0.0);
+    printf("seconds:     %.3f\n", seconds);
+    printf("steps/sec:   %.0f\n", seconds > 0 ? steps / seconds : 0.0);
+    printf("kernels:     %s\n", simdLevel());
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    long long frames = 1000000;
+    uint64_t seed = uint64_t(time(0));
+    const char* recordPath = nullptr;
+    const char* replayPath = nullptr;
+    int envs = 0;
+    int threads = 0;
+    LevelConfig level;
+    const char* saveLevelPath = nullptr;
+    bool spawnThread = false;
+    bool withAudio = false;
+    const char* renderPath = nullptr;
+    const char* capturePath = nullptr;
+    int renderWidth = WINDOW_WIDTH;
+    int renderHeight = WINDOW_HEIGHT;
+    int renderThreads = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (strcmp(argv[i], "--envs") == 0 && i + 1 < argc) {
+            envs = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--level") == 0 && i + 1 < argc) {
+            if (!level.load(argv[++i])) {
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--save-level") == 0 && i + 1 < argc) {
+            saveLevelPath = argv[++i];
+        } else if (strcmp(argv[i], "--spawn-thread") == 0) {
+            spawnThread = true;
+        } else if (strcmp(argv[i], "--audio") == 0) {
+            withAudio = true;
+        } else if (strcmp(argv[i], "--render") == 0 && i + 1 < argc) {
+            renderPath = argv[++i];
+        } else if (strcmp(argv[i], "--capture") == 0 && i + 1 < argc) {
+            capturePath = argv[++i];
+        } else if (strcmp(argv[i], "--render-size") == 0 && i + 1 < argc) {
+            if (sscanf(argv[++i], "%dx%d", &renderWidth, &renderHeight) != 2 || renderWidth <= 0 || renderHeight <= 0) {
+                usage(argv[0]);
+            }
+        } else if (strcmp(argv[i], "--render-threads") == 0 && i + 1 < argc) {
+            renderThreads = atoi(argv[++i]);
+        } else {
+            usage(argv[0]);
+        }
+    }
+    if ((recordPath && replayPath) || (envs > 0 && (recordPath || replayPath || spawnThread || withAudio || renderPath || capturePath))) {
+        usage(argv[0]);
+    }
+    if (saveLevelPath) {
+        if (!level.save(saveLevelPath)) {
+            fprintf(stderr, "Could not write level %s\n", saveLevelPath);
+            return 1;
+        }
+        return 0;
+    }
+    if (envs > 0) {
+        return runVecEnv(envs, threads, frames, seed, level);
+    }
+
+    Replay replay;
+    if (replayPath) {
+        if (!replay.load(replayPath)) {
+            fprintf(stderr, "Could not read replay %s\n", replayPath);
+            return 1;
+        }
+        if (replay.levelHash != level.hash()) {
+            fprintf(stderr, "%s was recorded on a different level; pass the same --level\n", replayPath);
+            return 1;
+        }
+        if (frames < replay.ticks()) {
+            fprintf(stderr, "--frames %lld ends before the replay's %lld ticks\n", frames, replay.ticks());
+            return 1;
+        }
+        seed = replay.seed;
+    } else if (recordPath) {
+        replay.begin(seed, level.hash());
+    }
+
+    AudioEngine audio;
+    if (withAudio) {
+        std::string program = argv[0];
+        size_t slash = program.find_last_of("/\\");
+        audio.start(slash == std::string::npos ? "" : program.substr(0, slash + 1).c_str(), true);
+    }
+
+    RunnerWorld world;
+    world.level = &level;
+    std::unique_ptr<HeadlessRenderer> renderer;
+    if (renderPath || capturePath) {
+        renderer.reset(new HeadlessRenderer(renderWidth, renderHeight, renderThreads, world.obstacles.capacity()));
+    }
+    VideoWriter video;
+    if (capturePath && !video.open(capturePath, renderWidth, renderHeight, TICK_RATE)) {
+        return 1;
+    }
+    if (spawnThread) {
+        world.spawns.startWorker();
+    }
+    world.seed = seed;
+    world.reset();
+
+    long long games = 0;
+    long long totalScore = 0;
+    bool checksumsMatch = true;
+
+    auto start = std::chrono::steady_clock::now();
+    for (long long frame = 0; frame < frames; frame++) {
+        if (world.gameOver || (replayPath && world.tick >= replay.ticks())) {
+            if (replayPath) {
+                checksumsMatch = checksumsMatch && world.checksum() == replay.checksum;
+            } else if (recordPath && games == 0 && !saveReplay(replay, world, recordPath)) {
+                return 1;
+            }
+            games++;
+            totalScore += world.score;
+            world.seed = replayPath ? seed : seed + games;
+            world.reset();
+        }
+
+        RunnerInput input = replayPath ? replay.at(world.tick) : autopilot(world);
+        if (recordPath && games == 0) {
+            replay.record(input);
+        }
+        world.applyInput(input);
+        world.step();
+        if (withAudio && world.events) {
+            // Posted the way the game posts them. What this checks is that
+            // posting never holds up the loop; how many the mixer played or
+            // dropped is printed at the end
+            if (world.events & EVENT_JUMP) audio.play(SOUND_JUMP);
+            if (world.events & EVENT_HIT) audio.play(SOUND_COLLISION);
+            if (world.events & (EVENT_COLLECT | EVENT_POWERUP)) audio.play(SOUND_COLLECT);
+            if (world.events & EVENT_LOSE) audio.play(SOUND_LOSE);
+            if (world.events & EVENT_WIN) audio.play(SOUND_WIN);
+        }
+        world.events = 0;
+
+        if (video.isOpen() && games == 0) {
+            // Framebuffer words are 0x00BBGGRR, which is RGBA byte order on
+            // little-endian machines
+            const Framebuffer& frame = renderer->draw(world);
+            memcpy(video.nextFrame(true), frame.pixels.data(), frame.pixels.size() * 4);
+            video.submit();
+        }
+    }
+    if (recordPath && games == 0 && !saveReplay(replay, world, recordPath)) {
+        // The first game outlasted --frames; keep what was played of it
+        return 1;
+    }
+    if (replayPath && (world.gameOver || world.tick >= replay.ticks())) {
+        // The last pass ended on the final frame
+        checksumsMatch = checksumsMatch && world.checksum() == replay.checksum;
+    }
+    if (video.isOpen() && !video.close()) {
+        return 1;
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    printf("frames:      %lld\n", frames);
+    printf("games:       %lld\n", games);
+    printf("avg score:   %.2f\n", games ? double(totalScore) / games : 0.0);
+    printf("seconds:     %.3f\n", seconds);
+    printf("frames/sec:  %.0f\n", seconds > 0 ? frames / seconds : 0.0);
+    printf("kernels:     %s\n", simdLevel());
+    if (withAudio) {
+        audio.stop();
+        printf("sounds:      %lld played, %lld dropped, %lld blocks mixed (%s backend)\n", audio.played(),
+               audio.dropped(), audio.blocksMixed(), audio.backendName());
+    }
+    if (capturePath) {
+        printf("video:       %s, %lld frames\n", capturePath, video.framesWritten());
+    }
+    if (renderPath) {
+        const Framebuffer& frame = renderer->draw(world);
+        if (!frame.writePpm(renderPath)) {
+            fprintf(stderr, "Could not write %s\n", renderPath);
+            return 1;
+        }
+        printf("image:       %s, %dx%d on %d threads, hash %016llx\n", renderPath, frame.width, frame.height,
+               renderer->raster.threadCount(), (unsigned long long)frame.hash());
+    }
+    if (replayPath) {
+        printf("checksum:    %016llx (%s)\n", (unsigned long long)replay.checksum,
+               checksumsMatch ? "matches the recording on every pass" : "MISMATCH with the recording");
+        return checksumsMatch ? 0 : 1;
+    }
+    return 0;
+}
@@ -0,0 +1,598 @@
+// Regression tests for the GL-free libraries. Each test is a function
+// registered in TESTS below; ctest runs every one as its own test.
+//
+//   runner-tests            run them all
+//   runner-tests NAME...    run the named ones
+#include "ByteIO.h"
+#include "EntityPool.h"
+#include "InputQueue.h"
+#include "LevelConfig.h"
+#include "Replay.h"
+#include "RunnerScene.h"
+#include "RunnerWorld.h"
+#include "SimdKernels.h"
+#include "SoftRasterizer.h"
+#include "SpawnSchedule.h"
+#include "VideoWriter.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static int failures = 0;
+
+#define CHECK(condition)                                                         \
+    do {                                                                         \
+        if (!(condition)) {                                                      \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            failures++;                                                          \
+        }                                                                        \
+    } while (0)
+
+// Scratch files live in the build tree
+static std::string scratchPath(const char* name) {
+    return std::string(RUNNER_TEST_DIR) + "/" + name;
+}
+
+static std::string sourcePath(const char* name) {
+    return std::string(RUNNER_SOURCE_DIR) + "/" + name;
+}
+
+static bool writeText(const std::string& path, const char* text) {
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file) return false;
+    fputs(text, file);
+    return fclose(file) == 0;
+}
+
+// Jumps every 40 ticks and ducks for a few ticks every 90, so a recording
+// has several input runs to encode.
+static RunnerInput scriptedInput(long long tick) {
+    RunnerInput input;
+    input.jump = tick % 40 == 0;
+    input.duck = tick % 90 < 6;
+    return input;
+}
+
+// Plays a run from seed with scriptedInput until it ends or ticks run out.
+static void playScripted(RunnerWorld& world, uint64_t seed, long long ticks, Replay* record) {
+    world.seed = seed;
+    world.reset();
+    while (!world.gameOver && world.tick < ticks) {
+        RunnerInput input = scriptedInput(world.tick);
+        if (record) record->record(input);
+        world.applyInput(input);
+        world.step();
+    }
+}
+
+static void testReplayRoundTrip() {
+    const LevelConfig& level = defaultLevel();
+    RunnerWorld recorded;
+    recorded.level = &level;
+    Replay replay;
+    replay.begin(42, level.hash());
+    playScripted(recorded, 42, 1 << 30, &replay);
+    replay.checksum = recorded.checksum();
+
+    std::string path = scratchPath("roundtrip.rnrp");
+    CHECK(replay.save(path.c_str()));
+    Replay loaded;
+    CHECK(loaded.load(path.c_str()));
+    CHECK(loaded.seed == 42);
+    CHECK(loaded.levelHash == level.hash());
+    CHECK(loaded.checksum == recorded.checksum());
+    CHECK(loaded.inputs == replay.inputs);
+
+    // Playing the loaded inputs back lands on the recorded state
+    RunnerWorld played;
+    played.level = &level;
+    played.seed = loaded.seed;
+    played.reset();
+    while (played.tick < loaded.ticks()) {
+        played.applyInput(loaded.at(played.tick));
+        played.step();
+    }
+    CHECK(played.checksum() == loaded.checksum);
+
+    // A tick count the runs cannot cover is rejected, not allocated
+    std::vector<uint8_t> data;
+    CHECK(readFile(path.c_str(), data));
+    data[29] = data[30] = data[31] = data[32] = 0xff;
+    std::string corrupt = scratchPath("corrupt.rnrp");
+    CHECK(writeFile(corrupt.c_str(), data));
+    CHECK(!loaded.load(corrupt.c_str()));
+    CHECK(loaded.checksum == recorded.checksum()); // Unchanged on failure
+}
+
+static void testLevelLoad() {
+    // The documented default level is the built-in one
+    LevelConfig level;
+    CHECK(level.load(sourcePath("levels/default.txt").c_str()));
+    CHECK(level.hash() == defaultLevel().hash());
+
+    // Text and binary forms of a level load identically
+    LevelConfig dense;
+    CHECK(dense.load(sourcePath("levels/dense.txt").c_str()));
+    CHECK(dense.hash() != defaultLevel().hash());
+    std::string binary = scratchPath("dense.rnlv");
+    CHECK(dense.save(binary.c_str()));
+    LevelConfig reloaded;
+    CHECK(reloaded.load(binary.c_str()));
+    CHECK(reloaded.hash() == dense.hash());
+    CHECK(reloaded.speedRamps.size() == dense.speedRamps.size());
+    CHECK(reloaded.magnetPullPerTick == dense.magnetPullPerTick);
+
+    // The magnet's per-second setting becomes a fixed pull per tick at
+    // TICK_RATE, like the rest of the level's tuning
+    double keptPerSecond = pow(1.0 - defaultLevel().magnetPullPerTick, TICK_RATE);
+    CHECK(fabs(keptPerSecond - MAGNET_KEEP_PER_SECOND) < 1e-5);
+    CHECK(fabs(defaultLevel().magnetPullPerTick - 0.1f) < 1e-6f);
+
+    // Speed ramps are looked up, not expanded per tick, so an endless level
+    // costs nothing extra
+    std::string endless = scratchPath("endless.txt");
+    CHECK(writeText(endless, "duration 2000000000\nspeed_ramp 100 0.5\nspeed_ramp 1000 0.25\n"));
+    LevelConfig longRun;
+    CHECK(longRun.load(endless.c_str()));
+    CHECK(longRun.speedIncreaseAt(0) == 0 && longRun.speedIncreaseAt(99) == 0);
+    CHECK(longRun.speedIncreaseAt(100) == 0.5f && longRun.speedIncreaseAt(999) == 0.5f);
+    CHECK(longRun.speedIncreaseAt(1000) == 0.25f && longRun.speedIncreaseAt(3000000000LL) == 0.25f);
+    CHECK(defaultLevel().speedIncreaseAt(GAME_DURATION + 10) == GAME_SPEED_INCREASE);
+}
+
+static void testLevelRejectsBadInput() {
+    const char* bad[] = {
+        "unknown_key 3\n",
+        "duration\n",
+        "duration 60 extra\n",
+        "duration -5\n",
+        "max_health 0\n",
+        "obstacle_spawn 5 4\n",
+        "speed_ramp 100 0.1\nspeed_ramp 50 0.2\n",
+        "magnet_keep_per_second 1.5\n",
+    };
+    std::string path = scratchPath("bad.txt");
+    for (const char* text : bad) {
+        LevelConfig level;
+        uint64_t before = level.hash();
+        CHECK(writeText(path, text));
+        bool loaded = level.load(path.c_str());
+        if (loaded) fprintf(stderr, "accepted bad level: %s", text);
+        CHECK(!loaded);
+        CHECK(level.hash() == before); // Unchanged on failure
+    }
+
+    // Every truncation of a valid binary level is rejected
+    std::string binary = scratchPath("default.rnlv");
+    CHECK(defaultLevel().save(binary.c_str()));
+    std::vector<uint8_t> data;
+    CHECK(readFile(binary.c_str(), data));
+    std::string truncated = scratchPath("truncated.rnlv");
+    for (size_t size = 4; size < data.size(); size++) {
+        std::vector<uint8_t> part(data.begin(), data.begin() + size);
+        CHECK(writeFile(truncated.c_str(), part));
+        LevelConfig level;
+        CHECK(!level.load(truncated.c_str()));
+    }
+}
+
+static void testEntityPoolSwapAndPop() {
+    EntityPool pool(4);
+    for (int i = 0; i < 4; i++) {
+        CHECK(pool.spawn({float(i), 0, float(i), 0, 0, false}));
+    }
+    CHECK(!pool.spawn({9, 0, 9, 0, 0, false})); // Full
+    CHECK(pool.size() == 4);
+
+    // The last object fills the hole
+    pool.kill(1);
+    CHECK(pool.size() == 3);
+    CHECK(pool.x[0] == 0 && pool.x[1] == 3 && pool.x[2] == 2);
+    CHECK(pool[1].prevX == 3);
+
+    // Removing from the highest index down leaves the survivors in order
+    pool.spawn({4, 0, 4, 0, 0, true});
+    int doomed[] = {0, 2};
+    for (int i = 1; i >= 0; i--) {
+        pool.kill(doomed[i]);
+    }
+    CHECK(pool.size() == 2);
+    CHECK(pool.x[0] == 4 && pool.x[1] == 3);
+    CHECK(pool[0].isHighObstacle && !pool[1].isHighObstacle);
+
+    pool.kill(1);
+    pool.kill(0);
+    CHECK(pool.empty());
+}
+
+static void testInputTiming() {
+    using std::chrono::milliseconds;
+    InputQueue::Clock::time_point start;
+    auto tickAt = [&](int n) { return start + milliseconds(n * 16); };
+
+    // A press stamped between two ticks lands on the later one
+    InputQueue queue;
+    queue.push(INPUT_JUMP, true, tickAt(1) + milliseconds(5));
+    queue.push(INPUT_JUMP, false, tickAt(1) + milliseconds(9));
+    CHECK(!queue.take(tickAt(1)).jump);
+    CHECK(!queue.pressed());
+    CHECK(queue.take(tickAt(2)).jump);
+    CHECK(queue.pressed() && queue.firstPress() == tickAt(1) + milliseconds(5));
+    CHECK(!queue.take(tickAt(3)).jump);
+
+    // Duck pressed and released inside one tick still ducks for that tick,
+    // and only that one
+    queue.push(INPUT_DUCK, true, tickAt(3) + milliseconds(2));
+    queue.push(INPUT_DUCK, false, tickAt(3) + milliseconds(6));
+    CHECK(queue.take(tickAt(4)).duck);
+    CHECK(!queue.take(tickAt(5)).duck);
+
+    // A held duck lasts until its release is due
+    queue.push(INPUT_DUCK, true, tickAt(5) + milliseconds(1));
+    queue.push(INPUT_DUCK, false, tickAt(7) + milliseconds(1));
+    CHECK(queue.take(tickAt(6)).duck);
+    CHECK(queue.take(tickAt(7)).duck);
+    CHECK(!queue.take(tickAt(8)).duck);
+
+    // Cleared presses never act
+    queue.push(INPUT_JUMP, true, tickAt(8) + milliseconds(1));
+    queue.clear();
+    CHECK(!queue.take(tickAt(9)).jump);
+
+    // Jump buffering: the first tick the player is back on the ground
+    RunnerWorld world;
+    world.seed = 1;
+    world.reset();
+    RunnerInput jump;
+    jump.jump = true;
+    world.applyInput(jump);
+    world.step();
+    while (world.isJumping) {
+        world.applyInput(RunnerInput());
+        world.step();
+    }
+    long long landing = world.tick;
+    CHECK(landing > JUMP_BUFFER_TICKS + 2);
+
+    // A press made in the air stays live for JUMP_BUFFER_TICKS ticks counting
+    // its own, so it fires on the landing tick if made fewer than that many
+    // ticks before it, and is lost otherwise
+    for (long long early = 1; early <= JUMP_BUFFER_TICKS + 2; early++) {
+        world.reset();
+        world.events = 0;
+        while (world.tick < landing) {
+            bool press = world.tick == 0 || world.tick == landing - early;
+            RunnerInput input;
+            input.jump = press;
+            world.applyInput(input);
+            CHECK(world.isJumping);
+            world.step();
+        }
+        world.events = 0;
+        world.applyInput(RunnerInput());
+        bool fired = world.isJumping && (world.events & EVENT_JUMP);
+        CHECK(fired == (early < JUMP_BUFFER_TICKS));
+    }
+}
+
+// The generator's speed at each distance it rolls spawns at, worked out
+// from the level's speed curve the same way: the world scrolls, spawns,
+// then speeds up. The generator never scrolls slower than 0.5 px per tick.
+static float speedAtDistance(const LevelConfig& level, double distance) {
+    float speed = level.initialSpeed;
+    double scrolled = 0;
+    for (long long tick = 0;; tick++) {
+        scrolled += std::max(speed, 0.5f);
+        if (scrolled >= distance) return speed;
+        speed += level.speedIncreaseAt(tick);
+    }
+}
+
+static double leftEdge(const SpawnEvent& event) {
+    const ObjectShape& shape = event.kind == SPAWN_OBSTACLE ? OBSTACLE_SHAPE
+                               : event.kind == SPAWN_POWERUP ? POWERUP_SHAPE : COLLECTABLE_SHAPE;
+    return event.distance + shape.minDX;
+}
+
+static double rightEdge(const SpawnEvent& event) {
+    const ObjectShape& shape = event.kind == SPAWN_OBSTACLE ? OBSTACLE_SHAPE
+                               : event.kind == SPAWN_POWERUP ? POWERUP_SHAPE : COLLECTABLE_SHAPE;
+    return event.distance + shape.maxDX;
+}
+
+static void testSpawnScheduleIsFair() {
+    const char* levels[] = {"levels/default.txt", "levels/dense.txt", "levels/sparse.txt", "levels/magnet-storm.txt"};
+    const int CHUNKS = 12;
+    for (const char* path : levels) {
+        LevelConfig level;
+        CHECK(level.load(sourcePath(path).c_str()));
+        float jumpTicks = 2 * level.jumpVelocity / level.gravity;
+        int obstacles = 0;
+        for (uint64_t seed = 1; seed <= 8; seed++) {
+            SpawnGenerator generator;
+            generator.reset(level, seed);
+            std::vector<SpawnEvent> events;
+            double end = 0;
+            for (int chunk = 0; chunk < CHUNKS; chunk++) {
+                end = generator.generate(events);
+            }
+            CHECK(end == double(CHUNKS) * SPAWN_CHUNK_LENGTH);
+
+            const SpawnEvent* lastObstacle = nullptr;
+            for (size_t i = 0; i < events.size(); i++) {
+                const SpawnEvent& event = events[i];
+                CHECK(i == 0 || event.distance >= events[i - 1].distance);
+                if (event.kind != SPAWN_OBSTACLE) continue;
+                obstacles++;
+                // Room to land and jump again, unless both are ducked under
+                if (lastObstacle && !(lastObstacle->variant && event.variant)) {
+                    float gap = jumpTicks * speedAtDistance(level, event.distance) + OBSTACLE_WIDTH + PLAYER_WIDTH;
+                    if (event.distance - lastObstacle->distance < gap) {
+                        fprintf(stderr, "%s seed %llu: obstacles at %.1f and %.1f are closer than %.1f\n", path,
+                                (unsigned long long)seed, lastObstacle->distance, event.distance, gap);
+                        failures++;
+                    }
+                }
+                lastObstacle = &event;
+            }
+
+            // No coin or powerup is drawn over an obstacle
+            for (const SpawnEvent& item : events) {
+                if (item.kind == SPAWN_OBSTACLE) continue;
+                for (const SpawnEvent& obstacle : events) {
+                    if (obstacle.kind != SPAWN_OBSTACLE) continue;
+                    if (leftEdge(item) < rightEdge(obstacle) && rightEdge(item) > leftEdge(obstacle)) {
+                        fprintf(stderr, "%s seed %llu: %s at %.1f overlaps the obstacle at %.1f\n", path,
+                                (unsigned long long)seed, item.kind == SPAWN_POWERUP ? "powerup" : "coin",
+                                item.distance, obstacle.distance);
+                        failures++;
+                    }
+                }
+            }
+
+            // The background worker hands out exactly the same events
+            SpawnSchedule inline_, threaded;
+            threaded.startWorker();
+            inline_.reset(level, seed);
+            threaded.reset(level, seed);
+            SpawnEvent a, b;
+            size_t taken = 0;
+            for (double distance = 0; distance < end; distance += 37) {
+                for (;;) {
+                    bool gotA = inline_.next(distance, a);
+                    bool gotB = threaded.next(distance, b);
+                    CHECK(gotA == gotB);
+                    if (!gotA || !gotB) break;
+                    CHECK(a.distance == b.distance && a.y == b.y && a.kind == b.kind && a.variant == b.variant);
+                    CHECK(taken < events.size() && a.distance == events[taken].distance && a.kind == events[taken].kind);
+                    taken++;
+                }
+            }
+        }
+        CHECK(obstacles > 0);
+    }
+}
+
+// Coordinates on a quarter-unit grid, so every sum below is exact and the
+// kernels' rearranged compares must agree with the plain ones
+static float gridValue(Rng& rng, int range) {
+    return float(int(rng.below(uint32_t(range * 4)))) * 0.25f;
+}
+
+static void testSimdKernelsMatchScalar() {
+    Rng rng(5);
+    int overlapHits = 0, magnetHits = 0, culled = 0;
+    // Counts around every vector width, so remainder loops are covered
+    for (int count : {0, 1, 3, 4, 7, 8, 9, 15, 16, 17, 31, 33, 100, 1000}) {
+        std::vector<float> x(count), y(count);
+        std::vector<uint8_t> high(count);
+        for (int i = 0; i < count; i++) {
+            x[i] = gridValue(rng, WINDOW_WIDTH);
+            y[i] = gridValue(rng, WINDOW_HEIGHT);
+            high[i] = uint8_t(rng.below(2));
+        }
+
+        Box target = {90, 50, 110, 110};
+        std::vector<int> out(count + 1), expected;
+        int found = findOverlaps(x.data(), y.data(), high.data(), count, OBSTACLE_SHAPE, target, out.data());
+        for (int i = 0; i < count; i++) {
+            if (overlaps(objectBox(OBSTACLE_SHAPE, x[i], y[i], high[i] != 0), target)) expected.push_back(i);
+        }
+        overlapHits += found;
+        CHECK(std::vector<int>(out.begin(), out.begin() + found) == expected);
+
+        expected.clear();
+        float cx = 100, cy = 60, radius = 250;
+        found = findAheadWithin(x.data(), y.data(), count, cx, cy, radius, out.data());
+        for (int i = 0; i < count; i++) {
+            float dx = cx - x[i], dy = cy - y[i];
+            if (x[i] > cx && dx * dx + dy * dy < radius * radius) expected.push_back(i);
+        }
+        magnetHits += found;
+        CHECK(std::vector<int>(out.begin(), out.begin() + found) == expected);
+
+        expected.clear();
+        std::vector<float> scrolled = x;
+        found = scrollAndCull(scrolled.data(), count, 2.5f, 300, out.data());
+        for (int i = 0; i < count; i++) {
+            CHECK(scrolled[i] == x[i] - 2.5f);
+            if (x[i] - 2.5f < 300) expected.push_back(i);
+        }
+        culled += found;
+        CHECK(std::vector<int>(out.begin(), out.begin() + found) == expected);
+    }
+    // The data has to exercise the hit paths, not only the misses
+    CHECK(overlapHits > 0 && magnetHits > 0 && culled > 0);
+}
+
+// Compares a frame's hash with the known-good one, printing the new hash
+// so an intended change to the rasterizer can update the table.
+static void checkFrame(const char* name, const Framebuffer& frame, uint64_t expected) {
+    uint64_t actual = frame.hash();
+    if (actual != expected) {
+        fprintf(stderr, "%s: frame hash %016llx, expected %016llx\n", name, (unsigned long long)actual,
+                (unsigned long long)expected);
+        failures++;
+    }
+}
+
+static void testRasterPrimitives() {
+    DrawBatch batch;
+    MeshBuilder builder(batch);
+    // A translucent square from two triangles: the shared diagonal must be
+    // blended once, so the whole square is one color
+    builder.color(1, 0, 0, 0.5f);
+    builder.quad(8, 8, 40, 8, 40, 40, 8, 40);
+    builder.color(0, 1, 0);
+    builder.triangle(44, 4, 60, 4, 52, 30);
+    builder.color(0, 0, 1);
+    builder.line(2, 50, 62, 58);
+    builder.wideLine(2, 44, 62, 36);
+    builder.color(1, 1, 0);
+    builder.point(52, 50);
+
+    Framebuffer frame;
+    frame.resize(64, 64);
+    frame.clear(0, 0, 0);
+    SoftRasterizer raster(1);
+    raster.begin(frame, 64, 64);
+    raster.add(batch);
+    raster.finish();
+
+    uint32_t square = frame.pixel(9, 9);
+    bool uniform = true;
+    for (int y = 8; y < 40; y++) {
+        for (int x = 8; x < 40; x++) {
+            if ((y > 35 && y < 46) || frame.pixel(x, y) == square) continue; // Where the wide line crosses
+            uniform = false;
+        }
+    }
+    CHECK(uniform);
+    CHECK(frame.pixel(7, 20) == 0 && frame.pixel(40, 20) == 0); // Right and top edges are exclusive
+    CHECK(frame.pixel(52, 50) == frame.pixel(51, 49) && frame.pixel(52, 50) == frame.pixel(53, 51)); // 3 px point
+    checkFrame("primitives", frame, 0xa47c7d197240e5bfULL);
+}
+
+static void testRasterSceneMeshes() {
+    SceneMeshes meshes;
+    buildSceneMeshes(meshes);
+    struct Case {
+        const char* name;
+        const DrawBatch* mesh;
+        uint64_t hash;
+    } cases[] = {
+        {"player_standing", &meshes.playerStanding, 0xef6bcdc499eaa157ULL},
+        {"player_ducking", &meshes.playerDucking, 0xa9535b7c1e4b12bdULL},
+        {"obstacle_low", &meshes.obstacleLow, 0x53f8fd2750c8f2a2ULL},
+        {"obstacle_high", &meshes.obstacleHigh, 0x24e1d41f8e45e665ULL},
+        {"collectable", &meshes.collectable, 0xde6dd4c3095b03d9ULL},
+        {"coin_magnet", &meshes.coinMagnet, 0x2f08235a1b92fcf2ULL},
+        {"double_points", &meshes.doublePoints, 0x3293c8eb6302eb09ULL},
+        {"heart", &meshes.heart, 0x29d2e99cd95e7a47ULL},
+    };
+    Framebuffer frame;
+    frame.resize(128, 192); // Room for the tall cactus
+    SoftRasterizer raster(1);
+    for (const Case& shape : cases) {
+        frame.clear(0, 0, 0);
+        raster.begin(frame, 128, 192);
+        raster.add(*shape.mesh, 64, 32);
+        raster.finish();
+        checkFrame(shape.name, frame, shape.hash);
+    }
+}
+
+// A whole scene mid-run, as runner-headless --render draws it
+static void testRasterFrame() {
+    RunnerWorld world;
+    playScripted(world, 42, 600, nullptr);
+    SceneMeshes meshes;
+    buildSceneMeshes(meshes);
+    SceneState scene;
+    scene.capture(world);
+    DrawBatch batch;
+    emitScene(scene, meshes, batch);
+
+    uint64_t hashes[2];
+    int threads[2] = {1, 3};
+    for (int i = 0; i < 2; i++) {
+        Framebuffer frame;
+        frame.resize(WINDOW_WIDTH, WINDOW_HEIGHT);
+        frame.clear(0, 0, 0);
+        SoftRasterizer raster(threads[i]);
+        raster.begin(frame, WINDOW_WIDTH, WINDOW_HEIGHT);
+        raster.add(meshes.ground);
+        raster.add(meshes.sky);
+        raster.add(batch);
+        raster.finish();
+        hashes[i] = frame.hash();
+        if (i == 0) checkFrame("frame", frame, 0xb54f18601c274dc0ULL);
+    }
+    CHECK(hashes[0] == hashes[1]); // Tiles shaded in parallel draw the same image
+}
+
+// Capture paths are split around their one %d, never passed to printf
+static void testVideoPatterns() {
+    const char* rejected[] = {"frame.ppm", "frame%s.ppm", "frame%n.ppm", "%d%d.ppm", "frame%5.ppm", "frame%-5d.ppm", "frame%"};
+    for (const char* pattern : rejected) {
+        VideoWriter video;
+        CHECK(!video.open(scratchPath(pattern).c_str(), 4, 2, 60));
+    }
+
+    VideoWriter video;
+    CHECK(video.open(scratchPath("video_%%_%03d.ppm").c_str(), 4, 2, 60));
+    for (int i = 0; i < 2; i++) {
+        uint8_t* frame = video.nextFrame(true);
+        memset(frame, 0x80, 4 * 2 * 4);
+        video.submit();
+    }
+    CHECK(video.close());
+    CHECK(video.framesWritten() == 2);
+    std::vector<uint8_t> bytes;
+    CHECK(readFile(scratchPath("video_%_000.ppm").c_str(), bytes));
+    CHECK(readFile(scratchPath("video_%_001.ppm").c_str(), bytes));
+    CHECK(bytes.size() == strlen("P6\n4 2\n255\n") + 4 * 2 * 3);
+}
+
+struct Test {
+    const char* name;
+    void (*run)();
+};
+
+static const Test TESTS[] = {
+    {"replay_round_trip", testReplayRoundTrip},
+    {"level_load", testLevelLoad},
+    {"level_rejects_bad_input", testLevelRejectsBadInput},
+    {"entity_pool_swap_and_pop", testEntityPoolSwapAndPop},
+    {"simd_kernels_match_scalar", testSimdKernelsMatchScalar},
+    {"spawn_schedule_is_fair", testSpawnScheduleIsFair},
+    {"input_timing", testInputTiming},
+    {"raster_primitives", testRasterPrimitives},
+    {"raster_scene_meshes", testRasterSceneMeshes},
+    {"raster_frame", testRasterFrame},
+    {"video_patterns", testVideoPatterns},
+};
+
+int main(int argc, char** argv) {
+    int ran = 0;
+    for (const Test& test : TESTS) {
+        bool selected = argc == 1;
+        for (int i = 1; i < argc; i++) {
+            selected = selected || strcmp(argv[i], test.name) == 0;
+        }
+        if (!selected) continue;
+
+        int before = failures;
+        test.run();
+        printf("%-28s %s\n", test.name, failures == before ? "ok" : "FAILED");
+        ran++;
+    }
+    if (ran == 0) {
+        fprintf(stderr, "no test matched\n");
+        return 1;
+    }
+    return failures == 0 ? 0 : 1;
+}